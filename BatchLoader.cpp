@@ -0,0 +1,92 @@
+//
+// Parallel loading of many DFA JSON files.
+//
+
+#include "BatchLoader.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include "JsonLoader.h"
+#include "ThreadPool.h"
+using namespace std;
+
+namespace fs = std::filesystem;
+
+static bool matchesPattern(const string &name, const string &pattern) {
+    // Wildcard matching met backtracking naar de laatste '*'
+    size_t n = 0, p = 0, starPattern = string::npos, starName = 0;
+    while (n < name.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+            ++n;
+            ++p;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            starPattern = p++;
+            starName = n;
+        } else if (starPattern != string::npos) {
+            p = starPattern + 1;
+            n = ++starName;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+static bool readFile(const string &path, string &contents) {
+    ifstream input(path, ios::binary | ios::ate);
+    if (!input) {
+        return false;
+    }
+    streamoff size = input.tellg();
+    if (size < 0) {
+        return false;
+    }
+    contents.resize(size);
+    input.seekg(0, ios::beg);
+    input.read(&contents[0], size);
+    return bool(input);
+}
+
+vector<LoadedDFA> loadDFAFiles(const vector<string> &paths, unsigned threadCount) {
+    vector<LoadedDFA> results(paths.size());
+    ThreadPool pool(threadCount, 2 * max(1u, threadCount == 0 ? ThreadPool::defaultThreadCount() : threadCount));
+
+    for (size_t i = 0; i < paths.size(); ++i) {
+        results[i].path = paths[i];
+
+        // I/O op deze thread, het parsen gebeurt in de pool terwijl het volgende bestand gelezen wordt
+        auto contents = make_shared<string>();
+        if (!readFile(paths[i], *contents)) {
+            pool.submit([path = paths[i]] {
+                throw runtime_error("cannot read " + path);
+            });
+            continue;
+        }
+
+        pool.submit([&results, i, contents] {
+            try {
+                results[i].dfa = parseCompiledDFA(*contents);
+            } catch (const exception &e) {
+                throw runtime_error(results[i].path + ": " + e.what());
+            }
+        });
+    }
+    pool.wait();
+    return results;
+}
+
+vector<LoadedDFA> loadDFADirectory(const string &directory, const string &pattern, unsigned threadCount) {
+    vector<string> paths;
+    for (const auto &entry : fs::directory_iterator(directory)) {
+        if (entry.is_regular_file() && matchesPattern(entry.path().filename().string(), pattern)) {
+            paths.push_back(entry.path().string());
+        }
+    }
+    sort(paths.begin(), paths.end());
+    return loadDFAFiles(paths, threadCount);
+}
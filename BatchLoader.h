@@ -0,0 +1,33 @@
+//
+// Parallel loading of many DFA JSON files.
+//
+
+#ifndef TABLEFILLINGALGORITHM_BATCHLOADER_H
+#define TABLEFILLINGALGORITHM_BATCHLOADER_H
+
+#include <string>
+#include <vector>
+#include "CompiledDFA.h"
+
+using namespace std;
+
+
+struct LoadedDFA {
+    string path;
+    CompiledDFA dfa;
+};
+
+// The calling thread reads the files one after the other while a pool of threadCount workers
+// (0 = all cores) parses the contents with the streaming loader. The queue between them is
+// bounded, so reading never runs far ahead of parsing. The results are compiled automata in
+// the order of paths; no distinguishability table is built, convert with toDFA() when the
+// table filling algorithm is needed. A file that cannot be read or parsed throws runtime_error
+// naming the file, after the other files have been processed.
+vector<LoadedDFA> loadDFAFiles(const vector<string> &paths, unsigned threadCount = 0);
+
+// All regular files in directory whose name matches pattern ('*' and '?' wildcards), sorted by path
+vector<LoadedDFA> loadDFADirectory(const string &directory, const string &pattern = "*.json",
+                                   unsigned threadCount = 0);
+
+
+#endif //TABLEFILLINGALGORITHM_BATCHLOADER_H
@@ -0,0 +1,412 @@
+//
+// Benchmarks of the DFA operations on synthetic families, results as JSON.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <unistd.h>
+#include "CompiledDFA.h"
+#include "DFA.h"
+#include "DFAGenerators.h"
+#include "HeapCounter.h"
+#include "JsonLoader.h"
+#include "JsonWriter.h"
+#include "MinimizationCache.h"
+#include "MinimizationStats.h"
+#include "PerfCounters.h"
+#include "Trace.h"
+#include "json.hpp"
+using namespace std;
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+struct Operation {
+    string name;
+    // Grootste aantal staten waarvoor de operatie nog gemeten wordt (de tabel is kwadratisch)
+    uint32_t maxStates;
+    // Lengte van de invoer voor accepts, anders 0
+    size_t inputLength;
+    // Verwachte groei van de tijd in het aantal staten, om te grote metingen over te slaan
+    int exponent;
+};
+
+static const vector<Operation> operations = {
+        {"loadJson", 100000, 0, 1},
+        {"loadCompiled", 1000000, 0, 1},
+        {"constructTable", 2000, 0, 2},
+        {"minimize", 2000, 0, 2},
+        {"minimizeCompiled", 1000000, 0, 1},
+        {"equals", 1000, 0, 2},
+        {"accepts", 1000000, 1000, 0},
+        {"acceptsCompiled", 1000000, 1000000, 0},
+};
+
+struct Options {
+    vector<string> families = dfaFamilies();
+    vector<uint32_t> sizes = {10, 100, 1000, 10000, 100000, 1000000};
+    vector<string> operations;
+    int repeat = 5;
+    double minTime = 0.01;
+    double maxTime = 10;
+    uint64_t seed = 1;
+    string output;
+    string trace;
+};
+
+static vector<string> split(const string &list) {
+    vector<string> parts;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        if (comma == string::npos) {
+            comma = list.size();
+        }
+        if (comma > start) {
+            parts.push_back(list.substr(start, comma - start));
+        }
+        start = comma + 1;
+    }
+    return parts;
+}
+
+static int usage() {
+    cerr << "usage: TableFillingBenchmark [--families f1,f2] [--sizes n1,n2] [--operations o1,o2]\n"
+            "                             [--repeat n] [--min-time seconds] [--max-time seconds] [--seed n]\n"
+            "                             [--output file] [--trace file]\n"
+            "families:";
+    for (const auto &family : dfaFamilies()) {
+        cerr << " " << family;
+    }
+    cerr << "\noperations:";
+    for (const auto &operation : operations) {
+        cerr << " " << operation.name;
+    }
+    cerr << endl;
+    return 2;
+}
+
+static bool parseOptions(int argc, char **argv, Options &options) {
+    for (const auto &operation : operations) {
+        options.operations.push_back(operation.name);
+    }
+    for (int i = 1; i < argc; ++i) {
+        string argument = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        string value = argv[++i];
+        if (argument == "--families") {
+            options.families = split(value);
+        } else if (argument == "--sizes") {
+            options.sizes.clear();
+            for (const auto &size : split(value)) {
+                options.sizes.push_back(stoul(size));
+            }
+        } else if (argument == "--operations") {
+            options.operations = split(value);
+        } else if (argument == "--repeat") {
+            options.repeat = max(1, stoi(value));
+        } else if (argument == "--min-time") {
+            options.minTime = stod(value);
+        } else if (argument == "--max-time") {
+            options.maxTime = stod(value);
+        } else if (argument == "--seed") {
+            options.seed = stoull(value);
+        } else if (argument == "--output") {
+            options.output = value;
+        } else if (argument == "--trace") {
+            options.trace = value;
+        } else {
+            return false;
+        }
+    }
+    for (const auto &name : options.operations) {
+        if (none_of(operations.begin(), operations.end(), [&](const Operation &o) { return o.name == name; })) {
+            cerr << "unknown operation: " << name << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Eén sample is de gemiddelde tijd per oproep over genoeg oproepen om minTime te halen; het aantal
+// oproepen wordt in de eerste sample bepaald en daarna vastgehouden. De hardwaretellers lopen over
+// alle samples en worden per oproep gerapporteerd. prepare (mag leeg zijn) loopt vóór elke oproep
+// buiten de klok en de tellers, voor de kopie die een operatie verandert.
+static json measure(const function<void()> &operation, const function<void()> &prepare, int repeat, double minTime,
+                    PerfCounters &counters) {
+    using clock = chrono::steady_clock;
+    size_t iterations = 0;
+    vector<double> samples;
+
+    counters.start();
+    counters.pause();
+    for (int sample = 0; sample < repeat; ++sample) {
+        // In de eerste sample tot minTime gehaald is
+        auto done = [&](size_t calls, double elapsed) {
+            return sample == 0 ? elapsed >= minTime && calls > 0 : calls == iterations;
+        };
+        size_t calls = 0;
+        double elapsed = 0;
+        if (!prepare) {
+            counters.resume();
+            auto start = clock::now();
+            while (!done(calls, elapsed)) {
+                operation();
+                ++calls;
+                if (sample == 0) {
+                    elapsed = chrono::duration<double>(clock::now() - start).count();
+                }
+            }
+            elapsed = chrono::duration<double>(clock::now() - start).count();
+            counters.pause();
+        } else {
+            // Klok en tellers per oproep, zodat prepare en het opruimen van de vorige kopie erbuiten vallen
+            while (!done(calls, elapsed)) {
+                prepare();
+                counters.resume();
+                auto start = clock::now();
+                operation();
+                elapsed += chrono::duration<double>(clock::now() - start).count();
+                counters.pause();
+                ++calls;
+            }
+        }
+        if (sample == 0) {
+            iterations = calls;
+        }
+        samples.push_back(elapsed / iterations);
+    }
+    counters.stop();
+
+    vector<double> sorted = samples;
+    sort(sorted.begin(), sorted.end());
+    double median = sorted.size() % 2 == 1 ? sorted[sorted.size() / 2]
+                                           : (sorted[sorted.size() / 2 - 1] + sorted[sorted.size() / 2]) / 2;
+    json result = {{"iterations", iterations}, {"samples", samples}, {"median", median}};
+    if (counters.isAvailable()) {
+        json perCall;
+        for (size_t counter = 0; counter < PerfCounters::getNames().size(); ++counter) {
+            perCall[PerfCounters::getNames()[counter]] =
+                    counters.hasValue(counter) ? json(counters.getValue(counter) / (iterations * repeat)) : json();
+        }
+        result["counters"] = perCall;
+    }
+    return result;
+}
+
+// Piek op de heap van één oproep bovenop wat er al leefde, naast de voorspelde bovengrens
+static json measureHeap(const function<void()> &operation, size_t predicted) {
+    resetHeapPeak();
+    size_t before = getHeapCurrent();
+    operation();
+    return {{"peak", getHeapPeak() - before}, {"predicted", predicted}};
+}
+
+// Tellers per invoerbyte (accepts) of per paar staten in de tabel (equals vult er één voor de
+// staten van beide automaten samen)
+static void addNormalizedCounters(json &result, const string &operation, size_t stateCount, size_t inputLength) {
+    if (!result.contains("counters")) {
+        return;
+    }
+    string unit;
+    double units = 0;
+    if (inputLength > 0) {
+        unit = "perByte";
+        units = inputLength;
+    } else if (operation == "constructTable" || operation == "minimize") {
+        unit = "perPair";
+        units = stateCount * (stateCount - 1) / 2.0;
+    } else if (operation == "equals") {
+        unit = "perPair";
+        units = 2 * stateCount * (2 * stateCount - 1) / 2.0;
+    }
+    if (units <= 0) {
+        return;
+    }
+    json normalized;
+    for (const auto &counter : result["counters"].items()) {
+        normalized[counter.key()] = counter.value().is_null() ? json() : json(counter.value().get<double>() / units);
+    }
+    result[unit] = normalized;
+}
+
+static string randomWord(const CompiledDFA &dfa, size_t length, uint64_t seed) {
+    mt19937_64 rng(seed);
+    string word(length, '\0');
+    for (char &c : word) {
+        c = dfa.getAlfabet()[rng() % dfa.getAlfabet().size()];
+    }
+    return word;
+}
+
+// Zelfde automaat met andere namen: equals() voegt staten met dezelfde naam samen
+static DFA renamed(const DFA &dfa, const string &prefix) {
+    DFA copy;
+    copy.setAlfabet(string(dfa.getAlfabet().begin(), dfa.getAlfabet().end()));
+    vector<string> states, acceptStates;
+    for (const auto &state : dfa.getStates()) {
+        states.push_back(prefix + state);
+    }
+    for (const auto &state : dfa.getAcceptStates()) {
+        acceptStates.push_back(prefix + state);
+    }
+    map<pair<string, char>, string> transitionFunction;
+    for (const auto &transition : dfa.getTransitionFunction()) {
+        transitionFunction[{prefix + transition.first.first, transition.first.second}] = prefix + transition.second;
+    }
+    copy.setStates(states);
+    copy.setAcceptStates(acceptStates);
+    copy.setStartState(prefix + dfa.getStartState());
+    copy.setTransitionFunction(transitionFunction);
+    return copy;
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return usage();
+    }
+    // Elke minimize() moet echt rekenen
+    MinimizationCache::setDefaultDirectory("");
+    if (!options.trace.empty()) {
+        startTracing();
+    }
+
+    string path = (fs::temp_directory_path() / ("tfa-benchmark-" + to_string(getpid()) + ".json")).string();
+    json results = json::array();
+    // Zonder PMU (virtuele machines, perf_event_paranoid) enkel de tijden
+    PerfCounters counters;
+    if (!counters.isAvailable()) {
+        cerr << "hardware counters unavailable (" << counters.getError() << "), reporting times only" << endl;
+    }
+    try {
+        for (const auto &family : options.families) {
+            // Vorige mediaan en grootte per operatie, om te voorspellen of de volgende grootte nog haalbaar is
+            map<string, pair<double, uint32_t>> previous;
+            for (uint32_t size : options.sizes) {
+                CompiledDFA compiled = generateFamily(family, size, options.seed);
+                DFA dfa;
+                bool hasDFA = false;
+                bool written = false;
+
+                for (const auto &operation : operations) {
+                    if (size > operation.maxStates ||
+                        find(options.operations.begin(), options.operations.end(), operation.name) ==
+                        options.operations.end()) {
+                        continue;
+                    }
+                    auto last = previous.find(operation.name);
+                    if (last != previous.end() && size > last->second.second) {
+                        double growth = pow(double(size) / last->second.second, operation.exponent);
+                        if (last->second.first * growth > options.maxTime) {
+                            cerr << family << " " << size << " " << operation.name << " skipped" << endl;
+                            continue;
+                        }
+                    }
+                    // De stringvorm en het JSON-bestand enkel als een operatie ze nodig heeft
+                    bool needsDFA = operation.name != "loadCompiled" && operation.name != "minimizeCompiled" &&
+                                    operation.name != "acceptsCompiled";
+                    if (needsDFA && !hasDFA) {
+                        dfa = compiled.toDFA();
+                        hasDFA = true;
+                    }
+                    if ((operation.name == "loadJson" || operation.name == "loadCompiled") && !written) {
+                        ofstream output(path);
+                        writeDFAJson(compiled, output);
+                        written = true;
+                    }
+                    DFA other = operation.name == "equals" ? renamed(dfa, "r") : DFA();
+                    string word = randomWord(compiled, operation.inputLength, options.seed);
+
+                    // Operaties die de automaat veranderen werken op een kopie die prepare klaarzet
+                    function<void()> run, prepare;
+                    DFA copy;
+                    if (operation.name == "loadJson") {
+                        run = [&] { DFA loaded(path); };
+                    } else if (operation.name == "loadCompiled") {
+                        run = [&] { loadCompiledDFA(path); };
+                    } else if (operation.name == "constructTable") {
+                        prepare = [&] { copy = dfa; };
+                        run = [&] { copy.constructTable(copy); };
+                    } else if (operation.name == "minimize") {
+                        prepare = [&] { copy = dfa; };
+                        run = [&] { copy.minimize(); };
+                    } else if (operation.name == "minimizeCompiled") {
+                        run = [&] { compiled.minimize(); };
+                    } else if (operation.name == "equals") {
+                        // equals() verandert geen van beide en drukt de tabel niet af, zoals operator==
+                        run = [&] {
+                            if (!dfa.equals(other)) {
+                                throw runtime_error("equals() says a DFA differs from itself");
+                            }
+                        };
+                    } else if (operation.name == "accepts") {
+                        run = [&] { dfa.accepts(word); };
+                    } else {
+                        run = [&] { compiled.accepts(word); };
+                    }
+
+                    resetMinimizationStats();
+                    json result = measure(run, prepare, options.repeat, options.minTime, counters);
+                    if (minimizationStatsEnabled()) {
+                        // Totalen over alle iterations * repeat oproepen van deze meting
+                        stringstream stats;
+                        writeMinimizationStatsJson(getMinimizationStats(), stats);
+                        result["stats"] = json::parse(stats.str());
+                    }
+                    // Eén oproep extra buiten de tijdsmeting, met de kopie al gemaakt
+                    if (operation.name == "minimize") {
+                        copy = dfa;
+                        size_t predicted = predictMinimizeBytes(copy);
+                        result["heap"] = measureHeap([&] { copy.minimize(); }, predicted);
+                    } else if (operation.name == "equals") {
+                        result["heap"] = measureHeap([&] { dfa.equals(other); }, predictEquivalenceBytes(dfa, other));
+                    }
+                    result["family"] = family;
+                    result["states"] = compiled.getStateCount();
+                    result["operation"] = operation.name;
+                    result["inputLength"] = operation.inputLength;
+                    addNormalizedCounters(result, operation.name, compiled.getStateCount(), operation.inputLength);
+                    results.push_back(result);
+                    previous[operation.name] = {result["median"].get<double>(), size};
+                    cerr << family << " " << size << " " << operation.name << " " << result["median"] << " s";
+                    if (result.contains("heap")) {
+                        cerr << ", heap " << result["heap"]["peak"] << " of " << result["heap"]["predicted"];
+                    }
+                    cerr << endl;
+                }
+            }
+        }
+    } catch (const exception &e) {
+        fs::remove(path);
+        cerr << e.what() << endl;
+        return 1;
+    }
+    fs::remove(path);
+    if (!options.trace.empty()) {
+        writeChromeTrace(options.trace);
+    }
+
+    json report = {{"repeat", options.repeat}, {"minTime", options.minTime}, {"maxTime", options.maxTime},
+                   {"seed", options.seed},
+                   {"results", results}};
+    if (options.output.empty()) {
+        cout << setw(4) << report << endl;
+    } else {
+        ofstream output(options.output);
+        output << setw(4) << report << endl;
+    }
+    return 0;
+}
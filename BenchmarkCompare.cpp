@@ -0,0 +1,271 @@
+//
+// Compares two TableFillingBenchmark reports: regressions per metric and empirical complexity.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <tuple>
+#include "json.hpp"
+using namespace std;
+
+using json = nlohmann::json;
+
+struct Options {
+    // Toegelaten relatieve vertraging per metriek, "time" of een hardwareteller
+    map<string, double> thresholds = {{"time", 0.10}, {"cycles", 0.10}, {"instructions", 0.05},
+                                      {"llcMisses", 0.25}, {"branchMisses", 0.25}};
+    // Een tijdsverschil telt pas als het ook zoveel keer de gecombineerde spreiding is
+    double noise = 3;
+    // Toegelaten stijging van de exponent t ~ n^k tegenover de baseline
+    double exponentTolerance = 0.3;
+    // Absolute bovengrenzen per operatie, bv. constructTable=2.5
+    map<string, double> maxExponents;
+    // Kleine groottes meten vooral vaste kosten, de fit begint pas hier
+    double minStates = 100;
+    // Een resultaat van de baseline dat in current ontbreekt telt als regressie, tenzij dit aan staat
+    // (bv. als current bewust maar een deel van de operaties meet)
+    bool allowMissing = false;
+    string baseline;
+    string current;
+};
+
+// (family, operation, states)
+typedef tuple<string, string, uint64_t> ResultKey;
+
+struct Result {
+    vector<double> samples;
+    double median = 0;
+    // Median absolute deviation, geschaald (1.4826) zodat ze de standaardafwijking schat bij normale ruis
+    double mad = 0;
+    map<string, double> counters;
+};
+
+static double medianOf(vector<double> values) {
+    if (values.empty()) {
+        return 0;
+    }
+    sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+static map<ResultKey, Result> loadReport(const string &path) {
+    ifstream input(path);
+    if (!input) {
+        throw runtime_error("cannot open " + path);
+    }
+    json report = json::parse(input);
+
+    map<ResultKey, Result> results;
+    for (const auto &entry : report.at("results")) {
+        Result result;
+        result.samples = entry.at("samples").get<vector<double>>();
+        result.median = medianOf(result.samples);
+        vector<double> deviations;
+        for (double sample : result.samples) {
+            deviations.push_back(fabs(sample - result.median));
+        }
+        result.mad = 1.4826 * medianOf(deviations);
+        if (entry.contains("counters")) {
+            for (const auto &counter : entry["counters"].items()) {
+                if (counter.value().is_number()) {
+                    result.counters[counter.key()] = counter.value().get<double>();
+                }
+            }
+        }
+        results[{entry.at("family"), entry.at("operation"), entry.at("states")}] = result;
+    }
+    return results;
+}
+
+// Helling van log(mediaan) tegen log(staten), kleinste kwadraten; false bij minder dan twee groottes
+static bool fitExponent(const map<ResultKey, Result> &results, const string &family, const string &operation,
+                        double minStates, double &exponent) {
+    vector<pair<double, double>> points;
+    for (const auto &entry : results) {
+        if (get<0>(entry.first) == family && get<1>(entry.first) == operation && get<2>(entry.first) >= minStates &&
+            entry.second.median > 0) {
+            points.emplace_back(log(double(get<2>(entry.first))), log(entry.second.median));
+        }
+    }
+    if (points.size() < 2) {
+        return false;
+    }
+    double meanX = 0, meanY = 0;
+    for (const auto &point : points) {
+        meanX += point.first / points.size();
+        meanY += point.second / points.size();
+    }
+    double covariance = 0, variance = 0;
+    for (const auto &point : points) {
+        covariance += (point.first - meanX) * (point.second - meanY);
+        variance += (point.first - meanX) * (point.first - meanX);
+    }
+    if (variance == 0) {
+        return false;
+    }
+    exponent = covariance / variance;
+    return true;
+}
+
+static int usage() {
+    cerr << "usage: TableFillingCompare [--threshold metric=fraction] [--noise k] [--exponent-tolerance d]\n"
+            "                           [--max-exponent operation=k] [--min-states n] [--allow-missing]\n"
+            "                           <baseline.json> <current.json>\n"
+            "metrics: time cycles instructions llcMisses branchMisses\n"
+            "a result of the baseline that is missing in current is a regression unless --allow-missing\n"
+            "exit status: 0 no regressions, 1 regressions, 2 invalid arguments or reports" << endl;
+    return 2;
+}
+
+static bool parseAssignment(const string &value, string &name, double &number) {
+    size_t equals = value.find('=');
+    if (equals == string::npos || equals == 0) {
+        return false;
+    }
+    name = value.substr(0, equals);
+    number = stod(value.substr(equals + 1));
+    return true;
+}
+
+static bool parseOptions(int argc, char **argv, Options &options) {
+    vector<string> files;
+    for (int i = 1; i < argc; ++i) {
+        string argument = argv[i];
+        if (argument.rfind("--", 0) != 0) {
+            files.push_back(argument);
+            continue;
+        }
+        if (argument == "--allow-missing") {
+            options.allowMissing = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        string value = argv[++i];
+        string name;
+        double number;
+        if (argument == "--threshold" && parseAssignment(value, name, number)) {
+            options.thresholds[name] = number;
+        } else if (argument == "--max-exponent" && parseAssignment(value, name, number)) {
+            options.maxExponents[name] = number;
+        } else if (argument == "--noise") {
+            options.noise = stod(value);
+        } else if (argument == "--exponent-tolerance") {
+            options.exponentTolerance = stod(value);
+        } else if (argument == "--min-states") {
+            options.minStates = stod(value);
+        } else {
+            return false;
+        }
+    }
+    if (files.size() != 2) {
+        return false;
+    }
+    options.baseline = files[0];
+    options.current = files[1];
+    return true;
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    map<ResultKey, Result> baseline, current;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            return usage();
+        }
+        baseline = loadReport(options.baseline);
+        current = loadReport(options.current);
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return usage();
+    }
+
+    int regressions = 0;
+    cout << left << setw(10) << "family" << setw(18) << "operation" << right << setw(9) << "states"
+         << setw(14) << "metric" << setw(14) << "baseline" << setw(14) << "current" << setw(10) << "change" << "\n";
+    auto report = [&](const ResultKey &key, const string &metric, double before, double after, bool regressed) {
+        double change = before > 0 ? (after - before) / before : 0;
+        cout << left << setw(10) << get<0>(key) << setw(18) << get<1>(key) << right << setw(9) << get<2>(key)
+             << setw(14) << metric << setw(14) << setprecision(4) << before << setw(14) << after
+             << setw(9) << fixed << setprecision(1) << 100 * change << "%" << defaultfloat
+             << (regressed ? "  REGRESSION" : "") << "\n";
+        regressions += regressed;
+    };
+
+    for (const auto &entry : current) {
+        auto previous = baseline.find(entry.first);
+        if (previous == baseline.end()) {
+            continue;
+        }
+        const Result &before = previous->second;
+        const Result &after = entry.second;
+
+        // Tijd: trager dan de drempel én buiten de ruis van beide metingen
+        double spread = sqrt(before.mad * before.mad + after.mad * after.mad);
+        bool slower = after.median > before.median * (1 + options.thresholds["time"]) &&
+                      after.median - before.median > options.noise * spread;
+        report(entry.first, "time", before.median, after.median, slower);
+
+        // Tellers zijn één totaal per meting, enkel de drempel
+        for (const auto &counter : after.counters) {
+            auto old = before.counters.find(counter.first);
+            if (old == before.counters.end() || options.thresholds.count(counter.first) == 0) {
+                continue;
+            }
+            report(entry.first, counter.first, old->second, counter.second,
+                   counter.second > old->second * (1 + options.thresholds[counter.first]));
+        }
+    }
+    // Een operatie die niet meer gemeten wordt (overgeslagen, gecrasht) mag geen regressie verbergen
+    for (const auto &entry : baseline) {
+        if (current.count(entry.first) == 0) {
+            bool regressed = !options.allowMissing;
+            cout << left << setw(10) << get<0>(entry.first) << setw(18) << get<1>(entry.first) << right
+                 << setw(9) << get<2>(entry.first) << setw(14) << "time" << setw(14) << setprecision(4)
+                 << entry.second.median << setw(14) << "missing" << setw(10) << "" << defaultfloat
+                 << (regressed ? "  REGRESSION" : "") << "\n";
+            regressions += regressed;
+        }
+    }
+
+    // Empirische complexiteit per (family, operation)
+    cout << "\n" << left << setw(10) << "family" << setw(18) << "operation" << right << setw(12) << "baseline k"
+         << setw(12) << "current k" << "\n";
+    map<pair<string, string>, bool> fitted;
+    for (const auto &entry : current) {
+        pair<string, string> series = {get<0>(entry.first), get<1>(entry.first)};
+        if (fitted[series]) {
+            continue;
+        }
+        fitted[series] = true;
+        double after;
+        if (!fitExponent(current, series.first, series.second, options.minStates, after)) {
+            continue;
+        }
+        double before;
+        bool hasBefore = fitExponent(baseline, series.first, series.second, options.minStates, before);
+        bool regressed = hasBefore && after > before + options.exponentTolerance;
+        auto limit = options.maxExponents.find(series.second);
+        if (limit != options.maxExponents.end() && after > limit->second) {
+            regressed = true;
+        }
+        cout << left << setw(10) << series.first << setw(18) << series.second << right << fixed << setprecision(2)
+             << setw(12);
+        if (hasBefore) {
+            cout << before;
+        } else {
+            cout << "-";
+        }
+        cout << setw(12) << after << defaultfloat << (regressed ? "  REGRESSION" : "") << "\n";
+        regressions += regressed;
+    }
+
+    cout << "\n" << regressions << (regressions == 1 ? " regression" : " regressions") << endl;
+    return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,376 @@
+//
+// Versioned, checksummed binary DFA format that can be used straight from an mmap'd file.
+//
+
+#include "BinaryDFA.h"
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "JsonLoader.h"
+using namespace std;
+
+static const char binaryDFAMagic[8] = {'T', 'F', 'A', 'D', 'F', 'A', '\0', '\0'};
+
+static bool hostIsLittleEndian() {
+    uint16_t value = 1;
+    unsigned char first;
+    memcpy(&first, &value, 1);
+    return first == 1;
+}
+
+static uint64_t alignTo8(uint64_t offset) {
+    return (offset + 7) & ~uint64_t(7);
+}
+
+// FNV-1a 64, incrementeel zodat de body niet in het geheugen moet staan om de checksum te kennen
+class ChecksumSink {
+public:
+    uint64_t value = 0xCBF29CE484222325ULL;
+
+    void operator()(const unsigned char *bytes, size_t length) {
+        for (size_t i = 0; i < length; ++i) {
+            value ^= bytes[i];
+            value *= 0x100000001B3ULL;
+        }
+    }
+};
+
+// Buffered little-endian writer die de bytes doorgeeft aan een sink
+template <typename Sink>
+class LittleEndianWriter {
+private:
+    Sink &sink;
+    unsigned char buffer[1 << 16];
+    size_t used = 0;
+
+public:
+    explicit LittleEndianWriter(Sink &sink) : sink(sink) {}
+
+    ~LittleEndianWriter() {
+        flush();
+    }
+
+    void flush() {
+        sink(buffer, used);
+        used = 0;
+    }
+
+    void putBytes(const void *bytes, size_t length) {
+        const unsigned char *source = static_cast<const unsigned char *>(bytes);
+        while (length > 0) {
+            if (used == sizeof(buffer)) {
+                flush();
+            }
+            size_t chunk = min(length, sizeof(buffer) - used);
+            memcpy(buffer + used, source, chunk);
+            used += chunk;
+            source += chunk;
+            length -= chunk;
+        }
+    }
+
+    template <typename Integer>
+    void put(Integer value) {
+        unsigned char bytes[sizeof(Integer)];
+        for (size_t i = 0; i < sizeof(Integer); ++i) {
+            bytes[i] = (unsigned char) (uint64_t(value) >> (8 * i));
+        }
+        putBytes(bytes, sizeof(Integer));
+    }
+
+    void padTo(uint64_t &position, uint64_t target) {
+        static const unsigned char zeros[8] = {};
+        putBytes(zeros, target - position);
+        position = target;
+    }
+};
+
+// Alles na de header, met de offsets uit header
+template <typename Sink>
+static void emitBody(const CompiledDFA &dfa, const BinaryDFAHeader &header, Sink &sink) {
+    LittleEndianWriter<Sink> writer(sink);
+    uint64_t position = sizeof(BinaryDFAHeader);
+
+    for (int c = 0; c < 256; ++c) {
+        int symbol = dfa.getSymbolIndex((char) c);
+        writer.put(uint16_t(symbol == -1 ? 0xFFFF : symbol));
+    }
+    writer.putBytes(dfa.getAlfabet().data(), dfa.getAlfabet().size());
+    position += 512 + dfa.getAlfabet().size();
+    writer.padTo(position, header.transitionsOffset);
+
+    for (uint32_t state = 0; state < header.stateCount; ++state) {
+        for (uint32_t symbol = 0; symbol < header.symbolCount; ++symbol) {
+            writer.put(dfa.getTransition(state, symbol));
+        }
+    }
+    position += uint64_t(header.stateCount) * header.symbolCount * 4;
+    writer.padTo(position, header.acceptOffset);
+
+    for (uint32_t word = 0; word < (header.stateCount + 63) / 64; ++word) {
+        uint64_t bits = 0;
+        for (uint32_t state = word * 64; state < header.stateCount && state < word * 64 + 64; ++state) {
+            if (dfa.isAccepting(state)) {
+                bits |= uint64_t(1) << (state % 64);
+            }
+        }
+        writer.put(bits);
+        position += 8;
+    }
+
+    if (header.flags & binaryDFAHasNames) {
+        uint64_t offset = 0;
+        writer.put(offset);
+        for (uint32_t state = 0; state < header.stateCount; ++state) {
+            offset += dfa.getStateName(state).size();
+            writer.put(offset);
+        }
+        for (uint32_t state = 0; state < header.stateCount; ++state) {
+            writer.putBytes(dfa.getStateName(state).data(), dfa.getStateName(state).size());
+        }
+        position += 8 * (uint64_t(header.stateCount) + 1) + offset;
+    }
+    writer.padTo(position, header.fileSize);
+}
+
+void writeBinaryDFA(const CompiledDFA &dfa, ostream &output, bool includeNames) {
+    BinaryDFAHeader header = {};
+    memcpy(header.magic, binaryDFAMagic, sizeof(header.magic));
+    header.version = binaryDFAVersion;
+    header.flags = includeNames ? binaryDFAHasNames : 0;
+    header.stateCount = dfa.getStateCount();
+    header.symbolCount = dfa.getAlfabet().size();
+    header.startState = dfa.getStartState();
+    header.symbolsOffset = sizeof(BinaryDFAHeader) + 512;
+    header.transitionsOffset = alignTo8(header.symbolsOffset + header.symbolCount);
+    header.acceptOffset = alignTo8(header.transitionsOffset + uint64_t(header.stateCount) * header.symbolCount * 4);
+    uint64_t end = header.acceptOffset + 8 * ((uint64_t(header.stateCount) + 63) / 64);
+    if (includeNames) {
+        header.namesOffset = end;
+        end += 8 * (uint64_t(header.stateCount) + 1);
+        for (uint32_t state = 0; state < header.stateCount; ++state) {
+            end += dfa.getStateName(state).size();
+        }
+    }
+    header.fileSize = alignTo8(end);
+
+    // Eerste doorgang berekent de checksum, de tweede schrijft
+    ChecksumSink checksum;
+    emitBody(dfa, header, checksum);
+    header.checksum = checksum.value;
+
+    auto toStream = [&](const unsigned char *bytes, size_t length) {
+        output.write(reinterpret_cast<const char *>(bytes), length);
+    };
+    {
+        LittleEndianWriter<decltype(toStream)> writer(toStream);
+        writer.putBytes(header.magic, sizeof(header.magic));
+        writer.put(header.version);
+        writer.put(header.flags);
+        writer.put(header.stateCount);
+        writer.put(header.symbolCount);
+        writer.put(header.startState);
+        writer.put(header.reserved);
+        writer.put(header.symbolsOffset);
+        writer.put(header.transitionsOffset);
+        writer.put(header.acceptOffset);
+        writer.put(header.namesOffset);
+        writer.put(header.fileSize);
+        writer.put(header.checksum);
+    }
+    emitBody(dfa, header, toStream);
+    if (!output) {
+        throw runtime_error("failed to write binary DFA");
+    }
+}
+
+void writeBinaryDFA(const CompiledDFA &dfa, const string &outputFile, bool includeNames) {
+    ofstream output(outputFile, ios::binary | ios::trunc);
+    if (!output) {
+        throw runtime_error("cannot open " + outputFile);
+    }
+    writeBinaryDFA(dfa, output, includeNames);
+}
+
+MappedDFA::MappedDFA(const string &inputFile) : data(nullptr), size(0) {
+    if (!hostIsLittleEndian()) {
+        throw runtime_error("binary DFA files can only be mapped on little-endian hosts");
+    }
+    int fd = open(inputFile.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw runtime_error("cannot open " + inputFile);
+    }
+    struct stat status;
+    if (fstat(fd, &status) == -1 || status.st_size < (off_t) sizeof(BinaryDFAHeader)) {
+        close(fd);
+        throw runtime_error(inputFile + " is not a binary DFA file");
+    }
+    size = status.st_size;
+    void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw runtime_error("cannot mmap " + inputFile);
+    }
+    data = static_cast<const unsigned char *>(mapping);
+    header = reinterpret_cast<const BinaryDFAHeader *>(data);
+
+    // Enkel de header en de grenzen van de secties, de inhoud wordt niet gelezen
+    uint64_t stateCount = header->stateCount;
+    uint64_t symbolCount = header->symbolCount;
+    bool valid = memcmp(header->magic, binaryDFAMagic, sizeof(header->magic)) == 0 &&
+                 header->version == binaryDFAVersion && header->fileSize == size && symbolCount <= 256 &&
+                 (header->startState < stateCount || header->startState == CompiledDFA::deadState) &&
+                 header->symbolsOffset == sizeof(BinaryDFAHeader) + 512 &&
+                 header->transitionsOffset == alignTo8(header->symbolsOffset + symbolCount) &&
+                 header->acceptOffset == alignTo8(header->transitionsOffset + stateCount * symbolCount * 4) &&
+                 header->acceptOffset + 8 * ((stateCount + 63) / 64) <= size;
+    if (valid && (header->flags & binaryDFAHasNames)) {
+        valid = header->namesOffset == header->acceptOffset + 8 * ((stateCount + 63) / 64) &&
+                header->namesOffset + 8 * (stateCount + 1) <= size;
+    }
+    if (!valid) {
+        munmap(const_cast<unsigned char *>(data), size);
+        throw runtime_error(inputFile + " is not a valid binary DFA file (version " + to_string(binaryDFAVersion) + ")");
+    }
+
+    symbolIndexes = reinterpret_cast<const uint16_t *>(data + sizeof(BinaryDFAHeader));
+    symbols = reinterpret_cast<const char *>(data + header->symbolsOffset);
+    transitions = reinterpret_cast<const uint32_t *>(data + header->transitionsOffset);
+    acceptBits = reinterpret_cast<const uint64_t *>(data + header->acceptOffset);
+    nameOffsets = nullptr;
+    names = nullptr;
+    if (header->flags & binaryDFAHasNames) {
+        nameOffsets = reinterpret_cast<const uint64_t *>(data + header->namesOffset);
+        names = reinterpret_cast<const char *>(nameOffsets + stateCount + 1);
+        // Oplopend en binnen de namen, zodat getStateName() nooit buiten het bestand leest
+        uint64_t nameBytes = size - (header->namesOffset + 8 * (stateCount + 1));
+        bool increasing = nameOffsets[0] == 0;
+        for (uint64_t state = 0; increasing && state < stateCount; ++state) {
+            increasing = nameOffsets[state] <= nameOffsets[state + 1];
+        }
+        if (!increasing || nameOffsets[stateCount] > nameBytes) {
+            munmap(const_cast<unsigned char *>(data), size);
+            throw runtime_error(inputFile + " has an invalid name table");
+        }
+    }
+
+    // Elk symbool één keer, en de tabel byte -> index moet daarmee overeenkomen (toCompiledDFA()
+    // gebruikt symbols, accepts() de tabel)
+    bool seen[256] = {};
+    for (uint64_t symbol = 0; valid && symbol < symbolCount; ++symbol) {
+        unsigned char c = symbols[symbol];
+        valid = !seen[c] && symbolIndexes[c] == symbol;
+        seen[c] = true;
+    }
+    for (int c = 0; valid && c < 256; ++c) {
+        valid = seen[c] || symbolIndexes[c] == 0xFFFF;
+    }
+    if (!valid) {
+        munmap(const_cast<unsigned char *>(data), size);
+        throw runtime_error(inputFile + " has an invalid alphabet");
+    }
+}
+
+MappedDFA::~MappedDFA() {
+    munmap(const_cast<unsigned char *>(data), size);
+}
+
+bool MappedDFA::verifyChecksum() const {
+    ChecksumSink checksum;
+    checksum(data + sizeof(BinaryDFAHeader), size - sizeof(BinaryDFAHeader));
+    return checksum.value == header->checksum;
+}
+
+bool MappedDFA::accepts(const string &input) const {
+    uint32_t currentState = header->startState;
+    for (char c : input) {
+        if (currentState == CompiledDFA::deadState) {
+            return false;
+        }
+        currentState = getTransitionOn(currentState, c);
+    }
+    return isAccepting(currentState);
+}
+
+uint32_t MappedDFA::getStateCount() const {
+    return header->stateCount;
+}
+
+uint32_t MappedDFA::getSymbolCount() const {
+    return header->symbolCount;
+}
+
+uint32_t MappedDFA::getStartState() const {
+    return header->startState;
+}
+
+uint32_t MappedDFA::getTransitionOn(uint32_t state, char c) const {
+    // Ook bij een niet geverifieerd bestand nooit buiten de tabel lezen
+    uint16_t symbol = symbolIndexes[(unsigned char) c];
+    if (state >= header->stateCount || symbol >= header->symbolCount) {
+        return CompiledDFA::deadState;
+    }
+    uint32_t to = transitions[size_t(state) * header->symbolCount + symbol];
+    return to < header->stateCount ? to : CompiledDFA::deadState;
+}
+
+bool MappedDFA::isAccepting(uint32_t state) const {
+    return state < header->stateCount && ((acceptBits[state / 64] >> (state % 64)) & 1);
+}
+
+bool MappedDFA::hasNames() const {
+    return names != nullptr;
+}
+
+string MappedDFA::getStateName(uint32_t state) const {
+    if (!hasNames() || state >= header->stateCount) {
+        return to_string(state);
+    }
+    return string(names + nameOffsets[state], nameOffsets[state + 1] - nameOffsets[state]);
+}
+
+CompiledDFA MappedDFA::toCompiledDFA() const {
+    CompiledDFA dfa;
+    for (uint32_t symbol = 0; symbol < header->symbolCount; ++symbol) {
+        // De constructor weigert dubbele symbolen, dus index == symbol
+        if (dfa.addSymbol(symbols[symbol]) != int(symbol)) {
+            throw runtime_error("binary DFA has a duplicate symbol");
+        }
+    }
+    dfa.reserveStates(header->stateCount);
+    for (uint32_t state = 0; state < header->stateCount; ++state) {
+        dfa.addState(getStateName(state));
+        dfa.setAccepting(state, isAccepting(state));
+    }
+    for (uint32_t state = 0; state < header->stateCount; ++state) {
+        for (uint32_t symbol = 0; symbol < header->symbolCount; ++symbol) {
+            uint32_t to = transitions[size_t(state) * header->symbolCount + symbol];
+            dfa.setTransition(state, symbol, to < header->stateCount ? to : CompiledDFA::deadState);
+        }
+    }
+    dfa.setStartState(header->startState);
+    return dfa;
+}
+
+CompiledDFA readBinaryDFA(const string &inputFile) {
+    MappedDFA mapped(inputFile);
+    if (!mapped.verifyChecksum()) {
+        throw runtime_error(inputFile + " fails its checksum");
+    }
+    return mapped.toCompiledDFA();
+}
+
+bool isBinaryDFAFile(const string &inputFile) {
+    char magic[8] = {};
+    ifstream input(inputFile, ios::binary);
+    input.read(magic, sizeof(magic));
+    return input && memcmp(magic, binaryDFAMagic, sizeof(magic)) == 0;
+}
+
+CompiledDFA readDFAFile(const string &inputFile) {
+    return isBinaryDFAFile(inputFile) ? readBinaryDFA(inputFile) : loadCompiledDFA(inputFile);
+}
@@ -0,0 +1,98 @@
+//
+// Versioned, checksummed binary DFA format that can be used straight from an mmap'd file.
+//
+
+#ifndef TABLEFILLINGALGORITHM_BINARYDFA_H
+#define TABLEFILLINGALGORITHM_BINARYDFA_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include "CompiledDFA.h"
+
+using namespace std;
+
+
+// File layout, every integer little-endian and every section 8-byte aligned:
+//   header         BinaryDFAHeader (80 bytes)
+//   alphabet map   uint16_t[256], byte value -> symbol index, 0xFFFF if not in the alphabet
+//   symbols        uint8_t[symbolCount]
+//   transitions    uint32_t[stateCount * symbolCount], row per state, 0xFFFFFFFF = no transition
+//   accept bitmap  uint64_t[(stateCount + 63) / 64], bit s of word s / 64 for state s
+//   names          optional: uint64_t[stateCount + 1] offsets into the bytes that follow
+// The checksum covers everything after the header.
+struct BinaryDFAHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint32_t stateCount;
+    uint32_t symbolCount;
+    uint32_t startState;
+    uint32_t reserved;
+    uint64_t symbolsOffset;
+    uint64_t transitionsOffset;
+    uint64_t acceptOffset;
+    uint64_t namesOffset;
+    uint64_t fileSize;
+    uint64_t checksum;
+};
+
+static_assert(sizeof(BinaryDFAHeader) == 80, "BinaryDFAHeader must not contain padding");
+
+const uint32_t binaryDFAVersion = 1;
+const uint32_t binaryDFAHasNames = 1;
+
+void writeBinaryDFA(const CompiledDFA &dfa, ostream &output, bool includeNames = true);
+void writeBinaryDFA(const CompiledDFA &dfa, const string &outputFile, bool includeNames = true);
+
+// Read-only view of a binary DFA file. The constructor maps the file and checks the header, the
+// section bounds, the alphabet and the name offsets, so matching can start without reading the
+// transition table first; verifyChecksum() reads the whole file. The checksum only detects
+// damage: every accessor also stays inside the file when the contents are invalid (a transition
+// to a state that does not exist counts as no transition). Throws runtime_error if the file
+// cannot be mapped or fails one of the checks.
+class MappedDFA {
+private:
+    const unsigned char *data;
+    size_t size;
+    const BinaryDFAHeader *header;
+    const uint16_t *symbolIndexes;
+    const char *symbols;
+    const uint32_t *transitions;
+    const uint64_t *acceptBits;
+    const uint64_t *nameOffsets;
+    const char *names;
+
+public:
+    explicit MappedDFA(const string &inputFile);
+    ~MappedDFA();
+
+    MappedDFA(const MappedDFA &) = delete;
+    MappedDFA &operator=(const MappedDFA &) = delete;
+
+    bool verifyChecksum() const;
+
+    bool accepts(const string &input) const;
+
+    uint32_t getStateCount() const;
+    uint32_t getSymbolCount() const;
+    uint32_t getStartState() const;
+    uint32_t getTransitionOn(uint32_t state, char c) const;
+    bool isAccepting(uint32_t state) const;
+    bool hasNames() const;
+    // Index as name when the file has no name table
+    string getStateName(uint32_t state) const;
+
+    CompiledDFA toCompiledDFA() const;
+};
+
+// Loads a binary DFA file into a CompiledDFA (checksum verified)
+CompiledDFA readBinaryDFA(const string &inputFile);
+
+// true when the file starts with the magic of BinaryDFAHeader
+bool isBinaryDFAFile(const string &inputFile);
+// readBinaryDFA() for binary files, loadCompiledDFA() (JSON) for everything else
+CompiledDFA readDFAFile(const string &inputFile);
+
+
+#endif //TABLEFILLINGALGORITHM_BINARYDFA_H
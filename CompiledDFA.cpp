@@ -0,0 +1,771 @@
+//
+// Integer-indexed form of a DFA, used by the algorithms that must scale.
+//
+
+#include "CompiledDFA.h"
+#include <algorithm>
+#include <memory_resource>
+#include <unordered_map>
+#include "Trace.h"
+using namespace std;
+
+CompiledDFA::CompiledDFA() : CompiledDFA(make_shared<StringPool>()) {}
+
+CompiledDFA::CompiledDFA(shared_ptr<StringPool> names) : names(move(names)), startState(deadState) {
+    symbolIndexes.fill(-1);
+}
+
+CompiledDFA::CompiledDFA(const DFA &dfa) : CompiledDFA() {
+    TraceSpan span("intern");
+    symbolIndexes.fill(-1);
+
+    // Alfabet, aangevuld met symbolen die enkel in de transities voorkomen (accepts() volgt die ook)
+    for (char c : dfa.getAlfabet()) {
+        if (symbolIndexes[(unsigned char) c] == -1) {
+            symbolIndexes[(unsigned char) c] = alfabet.size();
+            alfabet.push_back(c);
+        }
+    }
+    for (const auto &transition : dfa.getTransitionFunction()) {
+        char c = transition.first.second;
+        if (symbolIndexes[(unsigned char) c] == -1) {
+            symbolIndexes[(unsigned char) c] = alfabet.size();
+            alfabet.push_back(c);
+        }
+    }
+
+    // Nummer de staten, ook staten die enkel in transities of als startstaat voorkomen.
+    // De pool is nieuw, dus de id van een naam is meteen de index van de staat.
+    auto indexOf = [&](const string &state) {
+        uint32_t id = names->intern(state);
+        if (id == nameIds.size()) {
+            nameIds.push_back(id);
+        }
+        return id;
+    };
+    for (const auto &state : dfa.getStates()) {
+        indexOf(state);
+    }
+    if (!dfa.getStartState().empty()) {
+        startState = indexOf(dfa.getStartState());
+    }
+    for (const auto &transition : dfa.getTransitionFunction()) {
+        indexOf(transition.first.first);
+        indexOf(transition.second);
+    }
+
+    transitions.assign(nameIds.size() * alfabet.size(), deadState);
+    for (const auto &transition : dfa.getTransitionFunction()) {
+        uint32_t from = indexOf(transition.first.first);
+        int symbol = symbolIndexes[(unsigned char) transition.first.second];
+        transitions[from * alfabet.size() + symbol] = indexOf(transition.second);
+    }
+
+    accepting.assign(nameIds.size(), false);
+    for (const auto &acceptState : dfa.getAcceptStates()) {
+        uint32_t state;
+        if (names->find(acceptState, state)) {
+            accepting[state] = true;
+        }
+    }
+}
+
+bool CompiledDFA::accepts(string_view input) const {
+    uint32_t currentState = startState;
+    for (char c : input) {
+        if (currentState == deadState) {
+            return false;
+        }
+        currentState = getTransitionOn(currentState, c);
+    }
+    return isAccepting(currentState);
+}
+
+CompiledDFA CompiledDFA::trim(bool keepSink, pmr::memory_resource *scratch) const {
+    TraceSpan span("trim");
+    size_t stateCount = nameIds.size();
+    size_t symbolCount = alfabet.size();
+
+    // 1. Voorwaartse BFS vanaf de startstaat
+    pmr::vector<bool> reachable(stateCount, false, scratch);
+    pmr::vector<uint32_t> stateQueue(scratch);
+    if (startState != deadState) {
+        reachable[startState] = true;
+        stateQueue.push_back(startState);
+    }
+    for (size_t head = 0; head < stateQueue.size(); ++head) {
+        uint32_t state = stateQueue[head];
+        for (size_t symbol = 0; symbol < symbolCount; ++symbol) {
+            uint32_t to = transitions[state * symbolCount + symbol];
+            if (to != deadState && !reachable[to]) {
+                reachable[to] = true;
+                stateQueue.push_back(to);
+            }
+        }
+    }
+
+    // 2. Inverse index (CSR): voorgangers van elke bereikbare staat
+    pmr::vector<uint32_t> predecessorStart(stateCount + 1, 0, scratch);
+    for (uint32_t state : stateQueue) {
+        for (size_t symbol = 0; symbol < symbolCount; ++symbol) {
+            uint32_t to = transitions[state * symbolCount + symbol];
+            if (to != deadState) {
+                ++predecessorStart[to + 1];
+            }
+        }
+    }
+    for (size_t state = 0; state < stateCount; ++state) {
+        predecessorStart[state + 1] += predecessorStart[state];
+    }
+    pmr::vector<uint32_t> predecessors(predecessorStart[stateCount], scratch);
+    pmr::vector<uint32_t> fill(predecessorStart.begin(), predecessorStart.end() - 1, scratch);
+    for (uint32_t state : stateQueue) {
+        for (size_t symbol = 0; symbol < symbolCount; ++symbol) {
+            uint32_t to = transitions[state * symbolCount + symbol];
+            if (to != deadState) {
+                predecessors[fill[to]++] = state;
+            }
+        }
+    }
+
+    // 3. Achterwaartse BFS vanaf de bereikbare accepterende staten
+    pmr::vector<bool> live(stateCount, false, scratch);
+    pmr::vector<uint32_t> liveQueue(scratch);
+    for (uint32_t state : stateQueue) {
+        if (accepting[state]) {
+            live[state] = true;
+            liveQueue.push_back(state);
+        }
+    }
+    for (size_t head = 0; head < liveQueue.size(); ++head) {
+        uint32_t state = liveQueue[head];
+        for (uint32_t i = predecessorStart[state]; i < predecessorStart[state + 1]; ++i) {
+            uint32_t from = predecessors[i];
+            if (!live[from]) {
+                live[from] = true;
+                liveQueue.push_back(from);
+            }
+        }
+    }
+
+    // 4. Hernummer de overblijvende staten, in hun oorspronkelijke volgorde
+    pmr::vector<uint32_t> newIndexes(stateCount, deadState, scratch);
+    uint32_t sink = deadState;
+    CompiledDFA trimmed(names);
+    trimmed.alfabet = alfabet;
+    trimmed.symbolIndexes = symbolIndexes;
+    for (size_t state = 0; state < stateCount; ++state) {
+        if (reachable[state] && live[state]) {
+            newIndexes[state] = trimmed.nameIds.size();
+            trimmed.nameIds.push_back(nameIds[state]);
+        }
+    }
+    if (keepSink) {
+        // De eerste bereikbare dode staat (in BFS-volgorde) blijft over als enige put
+        for (uint32_t state : stateQueue) {
+            if (!live[state]) {
+                sink = trimmed.nameIds.size();
+                trimmed.nameIds.push_back(nameIds[state]);
+                break;
+            }
+        }
+    }
+
+    trimmed.accepting.assign(trimmed.nameIds.size(), false);
+    trimmed.transitions.assign(trimmed.nameIds.size() * symbolCount, deadState);
+    for (size_t state = 0; state < stateCount; ++state) {
+        uint32_t from = newIndexes[state];
+        if (from == deadState) {
+            continue;
+        }
+        trimmed.accepting[from] = accepting[state];
+        for (size_t symbol = 0; symbol < symbolCount; ++symbol) {
+            uint32_t to = transitions[state * symbolCount + symbol];
+            if (to != deadState) {
+                trimmed.transitions[from * symbolCount + symbol] = newIndexes[to] != deadState ? newIndexes[to] : sink;
+            }
+        }
+    }
+    if (sink != deadState) {
+        for (size_t symbol = 0; symbol < symbolCount; ++symbol) {
+            trimmed.transitions[sink * symbolCount + symbol] = sink;
+        }
+    }
+
+    if (startState != deadState) {
+        trimmed.startState = newIndexes[startState] != deadState ? newIndexes[startState] : sink;
+    }
+    return trimmed;
+}
+
+CompiledDFA CompiledDFA::minimize(pmr::memory_resource *scratch) const {
+    TraceSpan span("minimize");
+    CompiledDFA trimmed = trim(false, scratch);
+    size_t stateCount = trimmed.nameIds.size();
+    size_t symbolCount = alfabet.size();
+
+    CompiledDFA minimal(names);
+    minimal.alfabet = alfabet;
+    minimal.symbolIndexes = symbolIndexes;
+    if (stateCount == 0) {
+        return minimal;
+    }
+
+    // Hopcroft werkt op een volledige DFA: vul aan met een expliciete put met index stateCount
+    TraceSpan refine("refine");
+    size_t total = stateCount + 1;
+    auto target = [&](size_t state, size_t symbol) -> uint32_t {
+        if (state == stateCount) {
+            return stateCount;
+        }
+        uint32_t to = trimmed.transitions[state * symbolCount + symbol];
+        return to == deadState ? stateCount : to;
+    };
+
+    // Inverse transities per symbool (CSR, index symbol * total + state)
+    pmr::vector<uint32_t> inverseStart(symbolCount * total + 1, 0, scratch);
+    for (size_t state = 0; state < total; ++state) {
+        for (size_t symbol = 0; symbol < symbolCount; ++symbol) {
+            ++inverseStart[symbol * total + target(state, symbol) + 1];
+        }
+    }
+    for (size_t i = 0; i + 1 < inverseStart.size(); ++i) {
+        inverseStart[i + 1] += inverseStart[i];
+    }
+    pmr::vector<uint32_t> inverse(total * symbolCount, scratch);
+    {
+        pmr::vector<uint32_t> fill(inverseStart.begin(), inverseStart.end() - 1, scratch);
+        for (size_t state = 0; state < total; ++state) {
+            for (size_t symbol = 0; symbol < symbolCount; ++symbol) {
+                inverse[fill[symbol * total + target(state, symbol)]++] = state;
+            }
+        }
+    }
+
+    // Partitie: elk blok is een aaneengesloten stuk van elements, gemarkeerde staten vooraan
+    pmr::vector<uint32_t> elements(scratch);
+    pmr::vector<uint32_t> location(total, scratch);
+    pmr::vector<uint32_t> blockOf(total, scratch);
+    pmr::vector<uint32_t> blockFirst(scratch), blockEnd(scratch), blockMarked(scratch);
+    for (size_t state = 0; state < stateCount; ++state) {
+        if (trimmed.accepting[state]) {
+            elements.push_back(state);
+        }
+    }
+    size_t acceptingCount = elements.size();
+    for (size_t state = 0; state < total; ++state) {
+        if (state == stateCount || !trimmed.accepting[state]) {
+            elements.push_back(state);
+        }
+    }
+    // Na trim is er altijd minstens één accepterende staat, en de put is nooit accepterend
+    blockFirst = {0, uint32_t(acceptingCount)};
+    blockEnd = {uint32_t(acceptingCount), uint32_t(total)};
+    blockMarked = blockFirst;
+    for (size_t i = 0; i < total; ++i) {
+        location[elements[i]] = i;
+        blockOf[elements[i]] = i < acceptingCount ? 0 : 1;
+    }
+
+    pmr::vector<pair<uint32_t, uint32_t>> worklist(scratch);
+    pmr::vector<bool> inWorklist(2 * symbolCount, false, scratch);
+    uint32_t smallest = acceptingCount <= total - acceptingCount ? 0 : 1;
+    for (size_t symbol = 0; symbol < symbolCount; ++symbol) {
+        worklist.emplace_back(smallest, symbol);
+        inWorklist[smallest * symbolCount + symbol] = true;
+    }
+
+    pmr::vector<uint32_t> predecessors(scratch);
+    pmr::vector<uint32_t> touchedBlocks(scratch);
+    while (!worklist.empty()) {
+        uint32_t splitter = worklist.back().first;
+        uint32_t symbol = worklist.back().second;
+        worklist.pop_back();
+        inWorklist[splitter * symbolCount + symbol] = false;
+
+        // Verzamel eerst alle voorgangers, markeren verplaatst staten binnen hun blok
+        predecessors.clear();
+        for (uint32_t i = blockFirst[splitter]; i < blockEnd[splitter]; ++i) {
+            size_t index = symbol * total + elements[i];
+            predecessors.insert(predecessors.end(), inverse.begin() + inverseStart[index],
+                                inverse.begin() + inverseStart[index + 1]);
+        }
+
+        touchedBlocks.clear();
+        for (uint32_t state : predecessors) {
+            uint32_t block = blockOf[state];
+            if (location[state] < blockMarked[block]) {
+                continue;
+            }
+            if (blockMarked[block] == blockFirst[block]) {
+                touchedBlocks.push_back(block);
+            }
+            uint32_t other = elements[blockMarked[block]];
+            swap(elements[location[state]], elements[blockMarked[block]]);
+            location[other] = location[state];
+            location[state] = blockMarked[block]++;
+        }
+
+        // Splits elk geraakt blok in het gemarkeerde en het ongemarkeerde deel
+        for (uint32_t block : touchedBlocks) {
+            if (blockMarked[block] == blockEnd[block]) {
+                blockMarked[block] = blockFirst[block];
+                continue;
+            }
+            uint32_t newBlock = blockFirst.size();
+            blockFirst.push_back(blockFirst[block]);
+            blockEnd.push_back(blockMarked[block]);
+            blockMarked.push_back(blockFirst[block]);
+            blockFirst[block] = blockEnd[newBlock];
+            blockMarked[block] = blockFirst[block];
+            for (uint32_t i = blockFirst[newBlock]; i < blockEnd[newBlock]; ++i) {
+                blockOf[elements[i]] = newBlock;
+            }
+
+            inWorklist.resize(blockFirst.size() * symbolCount, false);
+            uint32_t smaller = blockEnd[newBlock] - blockFirst[newBlock] <= blockEnd[block] - blockFirst[block]
+                               ? newBlock : block;
+            for (size_t c = 0; c < symbolCount; ++c) {
+                uint32_t add = inWorklist[block * symbolCount + c] ? newBlock : smaller;
+                if (!inWorklist[add * symbolCount + c]) {
+                    inWorklist[add * symbolCount + c] = true;
+                    worklist.emplace_back(add, c);
+                }
+            }
+        }
+    }
+
+    refine.end();
+
+    // Quotiënt: blokken in volgorde van hun eerste staat, de put valt weg
+    TraceSpan quotient("quotient");
+    pmr::vector<uint32_t> newIndexes(blockFirst.size(), deadState, scratch);
+    pmr::vector<uint32_t> representatives(scratch);
+    pmr::vector<pmr::vector<string_view>> members(scratch);
+    for (size_t state = 0; state < stateCount; ++state) {
+        uint32_t block = blockOf[state];
+        if (newIndexes[block] == deadState) {
+            newIndexes[block] = representatives.size();
+            representatives.push_back(state);
+            members.emplace_back();
+        }
+        members[newIndexes[block]].push_back(trimmed.getStateName(state));
+    }
+
+    size_t classCount = representatives.size();
+    minimal.transitions.assign(classCount * symbolCount, deadState);
+    minimal.accepting.assign(classCount, false);
+    pmr::string name(scratch);
+    for (size_t c = 0; c < classCount; ++c) {
+        sort(members[c].begin(), members[c].end());
+        name = "{";
+        for (size_t i = 0; i < members[c].size(); ++i) {
+            if (i > 0) {
+                name += ", ";
+            }
+            name += members[c][i];
+        }
+        name += "}";
+        minimal.nameIds.push_back(names->intern(name));
+
+        uint32_t representative = representatives[c];
+        minimal.accepting[c] = trimmed.accepting[representative];
+        for (size_t symbol = 0; symbol < symbolCount; ++symbol) {
+            uint32_t to = trimmed.transitions[representative * symbolCount + symbol];
+            if (to != deadState) {
+                minimal.transitions[c * symbolCount + symbol] = newIndexes[blockOf[to]];
+            }
+        }
+    }
+    minimal.startState = newIndexes[blockOf[trimmed.startState]];
+    return minimal;
+}
+
+CompiledDFA CompiledDFA::canonical(pmr::memory_resource *scratch) const {
+    TraceSpan span("canonical");
+    CompiledDFA minimal = minimize(scratch);
+    size_t symbolCount = alfabet.size();
+
+    // Enkel symbolen die nog een transitie hebben, gesorteerd
+    pmr::vector<bool> used(symbolCount, false, scratch);
+    for (size_t i = 0; i < minimal.transitions.size(); ++i) {
+        if (minimal.transitions[i] != deadState) {
+            used[i % symbolCount] = true;
+        }
+    }
+    pmr::vector<size_t> symbolOrder(scratch);
+    for (size_t symbol = 0; symbol < symbolCount; ++symbol) {
+        if (used[symbol]) {
+            symbolOrder.push_back(symbol);
+        }
+    }
+    sort(symbolOrder.begin(), symbolOrder.end(), [&](size_t a, size_t b) {
+        return (unsigned char) alfabet[a] < (unsigned char) alfabet[b];
+    });
+
+    CompiledDFA canon;
+    for (size_t symbol : symbolOrder) {
+        canon.symbolIndexes[(unsigned char) alfabet[symbol]] = canon.alfabet.size();
+        canon.alfabet.push_back(alfabet[symbol]);
+    }
+    if (minimal.startState == deadState) {
+        return canon;
+    }
+
+    // BFS-nummering vanaf de start, na minimize is elke staat bereikbaar
+    pmr::vector<uint32_t> newIndexes(minimal.nameIds.size(), deadState, scratch);
+    pmr::vector<uint32_t> order({minimal.startState}, scratch);
+    newIndexes[minimal.startState] = 0;
+    for (size_t head = 0; head < order.size(); ++head) {
+        for (size_t symbol : symbolOrder) {
+            uint32_t to = minimal.transitions[order[head] * symbolCount + symbol];
+            if (to != deadState && newIndexes[to] == deadState) {
+                newIndexes[to] = order.size();
+                order.push_back(to);
+            }
+        }
+    }
+
+    size_t canonSymbols = canon.alfabet.size();
+    canon.startState = 0;
+    canon.transitions.assign(order.size() * canonSymbols, deadState);
+    canon.accepting.assign(order.size(), false);
+    for (size_t state = 0; state < order.size(); ++state) {
+        canon.nameIds.push_back(canon.names->intern(to_string(state)));
+        canon.accepting[state] = minimal.accepting[order[state]];
+        for (size_t i = 0; i < canonSymbols; ++i) {
+            uint32_t to = minimal.transitions[order[state] * symbolCount + symbolOrder[i]];
+            if (to != deadState) {
+                canon.transitions[state * canonSymbols + i] = newIndexes[to];
+            }
+        }
+    }
+    return canon;
+}
+
+string CompiledDFA::serialize(bool includeNames) const {
+    // Little-endian, onafhankelijk van het platform
+    string bytes;
+    auto put32 = [&](uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            bytes.push_back(char((value >> (8 * i)) & 0xFF));
+        }
+    };
+    put32(alfabet.size());
+    bytes.append(alfabet.begin(), alfabet.end());
+    put32(nameIds.size());
+    put32(startState);
+    for (size_t i = 0; i < accepting.size(); i += 8) {
+        unsigned char bits = 0;
+        for (size_t j = i; j < i + 8 && j < accepting.size(); ++j) {
+            bits |= accepting[j] << (j - i);
+        }
+        bytes.push_back(char(bits));
+    }
+    for (uint32_t to : transitions) {
+        put32(to);
+    }
+    if (includeNames) {
+        for (uint32_t id : nameIds) {
+            string_view name = names->get(id);
+            put32(name.size());
+            bytes += name;
+        }
+    }
+    return bytes;
+}
+
+bool CompiledDFA::deserialize(const string &bytes, CompiledDFA &dfa) {
+    size_t position = 0;
+    auto get32 = [&](uint32_t &value) {
+        if (bytes.size() - position < 4) {
+            return false;
+        }
+        value = 0;
+        for (int i = 3; i >= 0; --i) {
+            value = (value << 8) | (unsigned char) bytes[position + i];
+        }
+        position += 4;
+        return true;
+    };
+
+    CompiledDFA result;
+    uint32_t symbolCount, stateCount;
+    if (!get32(symbolCount) || bytes.size() - position < symbolCount) {
+        return false;
+    }
+    for (uint32_t i = 0; i < symbolCount; ++i) {
+        char c = bytes[position++];
+        if (result.symbolIndexes[(unsigned char) c] != -1) {
+            return false;
+        }
+        result.symbolIndexes[(unsigned char) c] = i;
+        result.alfabet.push_back(c);
+    }
+    if (!get32(stateCount) || !get32(result.startState)) {
+        return false;
+    }
+    if (result.startState != deadState && result.startState >= stateCount) {
+        return false;
+    }
+    size_t bitmapSize = (size_t(stateCount) + 7) / 8;
+    // Controleer de grootte vóór het alloceren, een corrupte telling mag geen gigabytes vragen
+    if (bytes.size() - position < bitmapSize ||
+        (bytes.size() - position - bitmapSize) / 4 < size_t(stateCount) * symbolCount) {
+        return false;
+    }
+    result.accepting.assign(stateCount, false);
+    for (uint32_t state = 0; state < stateCount; ++state) {
+        result.accepting[state] = ((unsigned char) bytes[position + state / 8] >> (state % 8)) & 1;
+    }
+    position += bitmapSize;
+    result.transitions.resize(size_t(stateCount) * symbolCount);
+    for (auto &to : result.transitions) {
+        if (!get32(to) || (to != deadState && to >= stateCount)) {
+            return false;
+        }
+    }
+
+    // Namen zijn optioneel, zonder namen krijgen de staten hun index als naam
+    result.nameIds.reserve(stateCount);
+    bool hasNames = position < bytes.size();
+    for (uint32_t state = 0; state < stateCount; ++state) {
+        if (!hasNames) {
+            result.nameIds.push_back(result.names->intern(to_string(state)));
+            continue;
+        }
+        uint32_t length;
+        if (!get32(length) || bytes.size() - position < length) {
+            return false;
+        }
+        result.nameIds.push_back(result.names->intern(string_view(bytes).substr(position, length)));
+        position += length;
+    }
+    if (position != bytes.size()) {
+        return false;
+    }
+
+    dfa = move(result);
+    return true;
+}
+
+Fingerprint CompiledDFA::fingerprint(pmr::memory_resource *scratch) const {
+    return hash128(canonical(scratch).serialize());
+}
+
+bool CompiledDFA::isIdenticalTo(const CompiledDFA &other) const {
+    return alfabet == other.alfabet && startState == other.startState && accepting == other.accepting &&
+           transitions == other.transitions;
+}
+
+DFA CompiledDFA::toDFA() const {
+    DFA dfa;
+    dfa.setAlfabet(string(alfabet.begin(), alfabet.end()));
+    vector<string> stateNames;
+    stateNames.reserve(nameIds.size());
+    for (uint32_t id : nameIds) {
+        stateNames.emplace_back(names->get(id));
+    }
+    dfa.setStates(stateNames);
+    if (startState != deadState) {
+        dfa.setStartState(stateNames[startState]);
+    }
+
+    vector<string> acceptStates;
+    map<pair<string, char>, string> transitionFunction;
+    for (size_t state = 0; state < nameIds.size(); ++state) {
+        if (accepting[state]) {
+            acceptStates.push_back(stateNames[state]);
+        }
+        for (size_t symbol = 0; symbol < alfabet.size(); ++symbol) {
+            uint32_t to = transitions[state * alfabet.size() + symbol];
+            if (to != deadState) {
+                transitionFunction[{stateNames[state], alfabet[symbol]}] = stateNames[to];
+            }
+        }
+    }
+    dfa.setAcceptStates(acceptStates);
+    dfa.setTransitionFunction(transitionFunction);
+    return dfa;
+}
+
+// Breadth-first search over the product automaton of lhs and rhs. Only pairs that are actually
+// reached get visited, and the search stops at the first pair for which found(p, q) holds, so the
+// witness is a shortest word leading to such a pair. Successors of pairs for which prune(p, q)
+// holds are not explored. Words are built over the alphabet of lhs: any other symbol sends lhs
+// to its dead state, and both checks below prune those pairs.
+template <typename Found, typename Prune>
+static bool findProductWitness(const CompiledDFA &lhs, const CompiledDFA &rhs, Found found, Prune prune,
+                               string &witness, pmr::memory_resource *scratch) {
+    auto key = [](uint32_t p, uint32_t q) { return (uint64_t(p) << 32) | q; };
+
+    // paar -> (vorig paar, symbool), om het getuige-woord te reconstrueren
+    pmr::unordered_map<uint64_t, pair<uint64_t, char>> parents(scratch);
+    pmr::vector<uint64_t> pairQueue(scratch);
+    witness.clear();
+
+    uint64_t startKey = key(lhs.getStartState(), rhs.getStartState());
+    parents.emplace(startKey, make_pair(startKey, '\0'));
+    pairQueue.push_back(startKey);
+
+    for (size_t head = 0; head < pairQueue.size(); ++head) {
+        uint64_t current = pairQueue[head];
+        uint32_t p = current >> 32;
+        uint32_t q = current & 0xFFFFFFFF;
+
+        if (found(p, q)) {
+            while (current != startKey) {
+                auto &parent = parents[current];
+                witness += parent.second;
+                current = parent.first;
+            }
+            reverse(witness.begin(), witness.end());
+            return true;
+        }
+        if (prune(p, q)) {
+            continue;
+        }
+
+        for (size_t symbol = 0; symbol < lhs.getAlfabet().size(); ++symbol) {
+            char c = lhs.getAlfabet()[symbol];
+            uint32_t nextP = lhs.getTransition(p, symbol);
+            uint32_t nextQ = q == CompiledDFA::deadState ? q : rhs.getTransitionOn(q, c);
+            uint64_t nextKey = key(nextP, nextQ);
+            if (parents.emplace(nextKey, make_pair(current, c)).second) {
+                pairQueue.push_back(nextKey);
+            }
+        }
+    }
+    return false;
+}
+
+bool CompiledDFA::isSubsetOf(const CompiledDFA &other, string &witness, pmr::memory_resource *scratch) const {
+    bool counterExample = findProductWitness(
+            *this, other,
+            [&](uint32_t p, uint32_t q) { return isAccepting(p) && !other.isAccepting(q); },
+            [&](uint32_t p, uint32_t) { return p == deadState; },
+            witness, scratch);
+    return !counterExample;
+}
+
+bool CompiledDFA::intersectionIsEmpty(const CompiledDFA &other, string &witness,
+                                      pmr::memory_resource *scratch) const {
+    bool common = findProductWitness(
+            *this, other,
+            [&](uint32_t p, uint32_t q) { return isAccepting(p) && other.isAccepting(q); },
+            [&](uint32_t p, uint32_t q) { return p == deadState || q == deadState; },
+            witness, scratch);
+    return !common;
+}
+
+bool CompiledDFA::isEmpty(string &witness, pmr::memory_resource *scratch) const {
+    return intersectionIsEmpty(*this, witness, scratch);
+}
+
+uint32_t CompiledDFA::addState(string_view name) {
+    return addStateWithNameId(names->intern(name));
+}
+
+uint32_t CompiledDFA::addStateWithNameId(uint32_t nameId) {
+    uint32_t state = nameIds.size();
+    nameIds.push_back(nameId);
+    accepting.push_back(false);
+    transitions.resize(transitions.size() + alfabet.size(), deadState);
+    return state;
+}
+
+int CompiledDFA::addSymbol(char c) {
+    int symbol = symbolIndexes[(unsigned char) c];
+    if (symbol != -1) {
+        return symbol;
+    }
+    symbol = alfabet.size();
+    symbolIndexes[(unsigned char) c] = symbol;
+    alfabet.push_back(c);
+
+    // Nieuwe kolom: herschik de bestaande rijen (enkel nodig als er al staten zijn)
+    size_t oldStride = alfabet.size() - 1;
+    if (!nameIds.empty()) {
+        transitions.resize(nameIds.size() * alfabet.size(), deadState);
+        for (size_t state = nameIds.size(); state-- > 0;) {
+            for (size_t i = oldStride; i-- > 0;) {
+                transitions[state * alfabet.size() + i] = transitions[state * oldStride + i];
+            }
+            transitions[state * alfabet.size() + oldStride] = deadState;
+        }
+    }
+    return symbol;
+}
+
+void CompiledDFA::setTransition(uint32_t fromState, int symbolIndex, uint32_t toState) {
+    transitions[fromState * alfabet.size() + symbolIndex] = toState;
+}
+
+void CompiledDFA::setAccepting(uint32_t state, bool accepting) {
+    CompiledDFA::accepting[state] = accepting;
+}
+
+void CompiledDFA::setStartState(uint32_t state) {
+    startState = state;
+}
+
+void CompiledDFA::reserveStates(size_t stateCount) {
+    nameIds.reserve(stateCount);
+    accepting.reserve(stateCount);
+    transitions.reserve(stateCount * alfabet.size());
+}
+
+uint32_t CompiledDFA::getStateCount() const {
+    return nameIds.size();
+}
+
+uint32_t CompiledDFA::getStartState() const {
+    return startState;
+}
+
+const vector<char> &CompiledDFA::getAlfabet() const {
+    return alfabet;
+}
+
+int CompiledDFA::getSymbolIndex(char c) const {
+    return symbolIndexes[(unsigned char) c];
+}
+
+uint32_t CompiledDFA::getTransition(uint32_t state, int symbolIndex) const {
+    if (state == deadState) {
+        return deadState;
+    }
+    return transitions[state * alfabet.size() + symbolIndex];
+}
+
+uint32_t CompiledDFA::getTransitionOn(uint32_t state, char c) const {
+    int symbol = getSymbolIndex(c);
+    if (symbol == -1) {
+        return deadState;
+    }
+    return getTransition(state, symbol);
+}
+
+bool CompiledDFA::isAccepting(uint32_t state) const {
+    return state != deadState && accepting[state];
+}
+
+string_view CompiledDFA::getStateName(uint32_t state) const {
+    return names->get(nameIds[state]);
+}
+
+uint32_t CompiledDFA::getStateNameId(uint32_t state) const {
+    return nameIds[state];
+}
+
+const shared_ptr<StringPool> &CompiledDFA::getStringPool() const {
+    return names;
+}
+
+MemoryUsage CompiledDFA::memoryUsage() const {
+    MemoryUsage usage;
+    usage.names = names->memoryUsage() + nameIds.capacity() * sizeof(uint32_t);
+    usage.transitions = transitions.capacity() * sizeof(uint32_t);
+    usage.indices = alfabet.capacity() + (accepting.capacity() + 63) / 64 * sizeof(uint64_t);
+    return usage;
+}
@@ -0,0 +1,122 @@
+//
+// Integer-indexed form of a DFA, used by the algorithms that must scale.
+//
+
+#ifndef TABLEFILLINGALGORITHM_COMPILEDDFA_H
+#define TABLEFILLINGALGORITHM_COMPILEDDFA_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "DFA.h"
+#include "Fingerprint.h"
+#include "MemoryUsage.h"
+#include "StringPool.h"
+
+using namespace std;
+
+
+class CompiledDFA {
+private:
+    // Namen van de staten als ids in names, de pool wordt gedeeld met afgeleide automaten
+    shared_ptr<StringPool> names;
+    vector<uint32_t> nameIds;
+    vector<char> alfabet;
+    // symbool -> kolom in transitions, -1 als het symbool niet in het alfabet zit
+    array<int, 256> symbolIndexes;
+    // transitions[state * alfabet.size() + symbol], deadState als er geen transitie is
+    vector<uint32_t> transitions;
+    vector<bool> accepting;
+    uint32_t startState;
+
+public:
+    // Implicit sink for missing transitions, same meaning as the "" state in DFA::accepts
+    static constexpr uint32_t deadState = UINT32_MAX;
+
+    // Default constructor, with a fresh name pool
+    CompiledDFA();
+    // Empty automaton whose state names are interned in an existing pool
+    explicit CompiledDFA(shared_ptr<StringPool> names);
+    // Compile a DFA, states keep the index they have in dfa.getStates()
+    explicit CompiledDFA(const DFA &dfa);
+
+    bool accepts(string_view input) const;
+
+    // The algorithms below take their temporary buffers from scratch; pass a monotonic arena to
+    // free everything at once afterwards. The returned automaton itself uses the normal heap.
+
+    // Remove states that are unreachable from the start or cannot reach an accepting state,
+    // in O(states * symbols). The result shares the name pool. Transitions into removed states
+    // become missing (deadState). With keepSink the reachable dead states are collapsed into one sink state instead, so a
+    // complete automaton stays complete (the table filling algorithm relies on that).
+    CompiledDFA trim(bool keepSink = false, pmr::memory_resource *scratch = pmr::get_default_resource()) const;
+
+    // Minimal automaton for the same language: trim, then Hopcroft partition refinement and the
+    // quotient construction. The result is trimmed (partial), merged states are named like
+    // DFA::minimize does ("{A, B}") and interned in the same pool.
+    CompiledDFA minimize(pmr::memory_resource *scratch = pmr::get_default_resource()) const;
+
+    // Canonical form: minimize, drop symbols without transitions, sort the alphabet and number
+    // the states in BFS order from the start (symbols in sorted order). Two automata accept the
+    // same language exactly when their canonical forms are identical.
+    CompiledDFA canonical(pmr::memory_resource *scratch = pmr::get_default_resource()) const;
+
+    // Deterministic byte serialization of the automaton in its current numbering. The state
+    // names are appended only when includeNames is set, the fingerprint leaves them out.
+    string serialize(bool includeNames = false) const;
+    // Inverse of serialize(), false if the bytes are truncated or inconsistent
+    static bool deserialize(const string &bytes, CompiledDFA &dfa);
+
+    // 128-bit hash of serialize() of the canonical form. Equal languages always give equal
+    // fingerprints, different languages only collide with probability ~2^-128.
+    Fingerprint fingerprint(pmr::memory_resource *scratch = pmr::get_default_resource()) const;
+
+    // Same alphabet order, transitions, accepting states and start state (names are ignored)
+    bool isIdenticalTo(const CompiledDFA &other) const;
+
+    // Back to the string based representation
+    DFA toDFA() const;
+
+    // L(this) ⊆ L(other)? If not, witness is a shortest word in L(this) \ L(other)
+    bool isSubsetOf(const CompiledDFA &other, string &witness,
+                    pmr::memory_resource *scratch = pmr::get_default_resource()) const;
+    // L(this) ∩ L(other) = ∅? If not, witness is a shortest word in both languages
+    bool intersectionIsEmpty(const CompiledDFA &other, string &witness,
+                             pmr::memory_resource *scratch = pmr::get_default_resource()) const;
+    // L(this) = ∅? If not, witness is a shortest accepted word
+    bool isEmpty(string &witness, pmr::memory_resource *scratch = pmr::get_default_resource()) const;
+
+    // Setters, used by loaders and generators that build the integer form directly
+    uint32_t addState(string_view name);
+    // Same, with a name that is already interned in getStringPool()
+    uint32_t addStateWithNameId(uint32_t nameId);
+    int addSymbol(char c);
+    void setTransition(uint32_t fromState, int symbolIndex, uint32_t toState);
+    void setAccepting(uint32_t state, bool accepting);
+    void setStartState(uint32_t state);
+    void reserveStates(size_t stateCount);
+
+    // Getters
+    uint32_t getStateCount() const;
+    uint32_t getStartState() const;
+    const vector<char> &getAlfabet() const;
+    int getSymbolIndex(char c) const;
+    uint32_t getTransition(uint32_t state, int symbolIndex) const;
+    uint32_t getTransitionOn(uint32_t state, char c) const;
+    bool isAccepting(uint32_t state) const;
+    // Valid as long as the pool lives
+    string_view getStateName(uint32_t state) const;
+    uint32_t getStateNameId(uint32_t state) const;
+    const shared_ptr<StringPool> &getStringPool() const;
+
+    // Heap bytes, see MemoryUsage.h. names counts the whole pool, which may be shared with the
+    // automata made by trim() and minimize(); table is always 0.
+    MemoryUsage memoryUsage() const;
+};
+
+
+#endif //TABLEFILLINGALGORITHM_COMPILEDDFA_H
@@ -9,42 +9,61 @@
 #include <utility>
 #include <stack>
 #include <queue>
+#include <set>
+#include <memory_resource>
 #include "json.hpp"
+#include "BinaryDFA.h"
+#include "CompiledDFA.h"
+#include "JsonWriter.h"
+#include "MinimizationCache.h"
+#include "MinimizationStats.h"
+#include "Trace.h"
 using namespace std;
 
 using json = nlohmann::json;
 
-vector<pair<string, string>> findSourceStates(const pair<string, string> &statePair, const DFA& dfa) {
-    vector<pair<string, string>> sourceStates;
-    for (char input : dfa.getAlfabet()) {
-        // Zoekt alle fromtopairen op 1 input
-        vector<pair<string, string>> fromToPairOnInput;
-        map<pair<string, char>, string> transitionFunction = dfa.getTransitionFunction();
-        for (const auto& transition : transitionFunction) {
-            if (transition.first.second == input) {
-                fromToPairOnInput.push_back(make_pair(transition.first.first, transition.second));
+// Voorgangers per (symbool, doelstaat) als indexen in de gesorteerde staten, één keer opgebouwd
+// per tabel: sources[symbol * states + to]
+typedef pmr::vector<pmr::vector<int>> SourceIndex;
+
+static int indexOfSortedState(const vector<string> &sortedStates, const string &state) {
+    auto it = lower_bound(sortedStates.begin(), sortedStates.end(), state);
+    if (it == sortedStates.end() || *it != state) {
+        return -1;
+    }
+    return it - sortedStates.begin();
+}
+
+static SourceIndex buildSourceIndex(const DFA &dfa, pmr::memory_resource *scratch) {
+    size_t stateCount = dfa.getStates().size();
+    SourceIndex sources(dfa.getAlfabet().size() * stateCount, scratch);
+    for (size_t symbol = 0; symbol < dfa.getAlfabet().size(); ++symbol) {
+        char input = dfa.getAlfabet()[symbol];
+        for (const auto &transition : dfa.getTransitionFunction()) {
+            if (transition.first.second != input) {
+                continue;
             }
-        }
-        // Check if both states in statePair are present in fromToPairOnInput
-        for (int i = 0; i < fromToPairOnInput.size(); ++i) {
-            if (fromToPairOnInput[i].second == statePair.first) {
-                for (int j = 0; j < fromToPairOnInput.size(); ++j) {
-                    if (fromToPairOnInput[j].second == statePair.second) {
-                        sourceStates.push_back(make_pair(fromToPairOnInput[i].first, fromToPairOnInput[j].first));
-                    }
-                }
+            int from = indexOfSortedState(dfa.getStates(), transition.first.first);
+            int to = indexOfSortedState(dfa.getStates(), transition.second);
+            if (from != -1 && to != -1) {
+                sources[symbol * stateCount + to].push_back(from);
             }
         }
     }
+    return sources;
+}
 
-
-    for (int i = 0; i < sourceStates.size(); ++i) {
-        if (sourceStates[i].first > sourceStates[i].second) {
-            swap(sourceStates[i].first, sourceStates[i].second);
+// Alle paren (i, j) met i < j die op hetzelfde symbool naar het paar (first, second) gaan
+static void findSourceStates(int first, int second, const SourceIndex &sources, size_t stateCount,
+                             pmr::vector<pair<int, int>> &sourceStates) {
+    sourceStates.clear();
+    for (size_t offset = 0; offset < sources.size(); offset += stateCount) {
+        for (int i : sources[offset + first]) {
+            for (int j : sources[offset + second]) {
+                sourceStates.push_back(i < j ? make_pair(i, j) : make_pair(j, i));
+            }
         }
     }
-
-    return sourceStates;
 }
 
 pair<int, int> DFA::getIndexesForStatePair(pair<string, string>& statePair, const vector<string>& states) {
@@ -53,7 +72,9 @@ pair<int, int> DFA::getIndexesForStatePair(pair<string, string>& statePair, cons
     return make_pair(index1, index2-1);
 }
 
-vector<vector<bool>> DFA::constructTable(DFA& dfa) {
+vector<vector<bool>> DFA::constructTable(DFA& dfa, pmr::memory_resource *scratch) {
+    TraceSpan span("table");
+    TFA_STATS_TIMER(tableNanos);
     // Maak een vector van vectoren om de tabel op te slaan
     vector<vector<bool>> table(dfa.getStates().size()-1, vector<bool>(dfa.getStates().size()-1, false));
 
@@ -64,50 +85,65 @@ vector<vector<bool>> DFA::constructTable(DFA& dfa) {
 
     // 1. Aankruising accepterende staten
     // Zoek de index van de final states
-    vector<int> finalStateIndexes;
+    pmr::vector<bool> isFinalState(sortedStates.size(), false, scratch);
     for (const auto& acceptState : dfa.getAcceptStates()) {
-        auto it = find(dfa.getStates().begin(), dfa.getStates().end(), acceptState);
-        if (it != dfa.getStates().end()) {
-            int index = distance(dfa.getStates().begin(), it);
-            finalStateIndexes.push_back(index);
+        int index = indexOfSortedState(dfa.getStates(), acceptState);
+        if (index != -1) {
+            isFinalState[index] = true;
         }
     }
     // Markeer alle cellen die overgangen van accepterende naar niet-accepterende staten bevatten
+    uint64_t initialMarks = 0;
     for (int i = 0; i < table.size(); ++i) {
         for (int j = 0; j <= i; ++j) {
-            bool row = find(finalStateIndexes.begin(), finalStateIndexes.end(), i+1) != finalStateIndexes.end();
-            bool col = find(finalStateIndexes.begin(), finalStateIndexes.end(), j) != finalStateIndexes.end();
+            bool row = isFinalState[i+1];
+            bool col = isFinalState[j];
             if ((row && !col) || (!row && col)) {
                 table[i][j] = true;
+                ++initialMarks;
             }
         }
     }
+    TFA_STATS_ADD(initialMarks, initialMarks);
 
 
     // 2. Zoek transitie paren
+    SourceIndex sources = buildSourceIndex(dfa, scratch);
+    pmr::vector<pair<int, int>> sourceStates(scratch);
+    uint64_t rounds = 0, pairsMarked = 0, calls = 0, sourcePairs = 0;
+    TraceSpan refine("refine");
     bool marked = true;
     while (marked) {
         marked = false;
+        ++rounds;
         for (int i = 0; i < table.size(); ++i) {
             for (int j = 0; j <= i; ++j) {
                 if (table[i][j]) {
                     // Check if there is a transition from (i, j) to any state (k) on input symbol 'input'
-                    vector<pair<string, string>> sourceStates = findSourceStates({dfa.getStates()[j], dfa.getStates()[i + 1]}, dfa);
-                    if (!sourceStates.empty()) {
-                        for (auto &sourceState: sourceStates) {
-                            // Find the index of the source state
-                            pair<int, int> indexesSourcePair = getIndexesForStatePair(sourceState, dfa.getStates());
-                            if (!table[indexesSourcePair.second][indexesSourcePair.first]) {
-                                marked = true;
-                            }
-                            table[indexesSourcePair.second][indexesSourcePair.first] = true;
+                    findSourceStates(j, i + 1, sources, sortedStates.size(), sourceStates);
+                    ++calls;
+                    sourcePairs += sourceStates.size();
+                    for (auto &sourceState: sourceStates) {
+                        // Rij van de grootste index (min 1), kolom van de kleinste
+                        if (!table[sourceState.second - 1][sourceState.first]) {
+                            marked = true;
+                            ++pairsMarked;
                         }
+                        table[sourceState.second - 1][sourceState.first] = true;
                     }
                 }
             }
         }
     }
 
+    refine.end();
+    TFA_STATS_ADD(tables, 1);
+    TFA_STATS_ADD(tableCells, uint64_t(table.size()) * (table.size() + 1) / 2);
+    TFA_STATS_ADD(fixpointRounds, rounds);
+    TFA_STATS_ADD(pairsMarked, pairsMarked);
+    TFA_STATS_ADD(findSourceStatesCalls, calls);
+    TFA_STATS_ADD(sourcePairs, sourcePairs);
+
     dfa.setTable(table);
 
     return table;
@@ -116,6 +152,8 @@ vector<vector<bool>> DFA::constructTable(DFA& dfa) {
 DFA::DFA() {}
 
 DFA::DFA(const string inputFile) {
+    TraceSpan span("parse");
+    TFA_STATS_TIMER(loadNanos);
     // inlezen uit file
     ifstream input(inputFile);
 
@@ -142,6 +180,8 @@ DFA::DFA(const string inputFile) {
             acceptStates.push_back(state["name"]);
         }
     }
+    // Sorteer de staten zoals constructTable dat doet, de tabel zelf volgt pas bij getTable()
+    sort(states.begin(), states.end());
     setStates(states);
     setAcceptStates(acceptStates);
     setStartState(startState);
@@ -162,8 +202,8 @@ DFA::DFA(const string inputFile) {
         transitionFunction[make_pair(fromState, inputChar)] += toState;
     }
     setTransitionFunction(transitionFunction);
-
-    setTable(constructTable(*this));
+    TFA_STATS_ADD(loads, 1);
+    TFA_STATS_ADD(loadedStates, states.size());
 }
 
 bool DFA::accepts(string input) {
@@ -171,55 +211,35 @@ bool DFA::accepts(string input) {
     // Loop over the input
     for (char c : input) {
         // Kijkt of er een transitie bestaat op het staat, input paar
-        if (transitionFunction.count({currentState, c}) == 0) {
-            // Doe niets, current staat blijft hetzelfde
-            currentState = currentState;
+        auto it = transitionFunction.find({currentState, c});
+        if (it == transitionFunction.end()) {
+            // Geen transitie: de lege (dode) staat, zonder de map aan te passen
+            currentState = "";
+        } else {
+            // Als er een transitiefunctie bestaat dan verander je de
+            // current staat naar de nieuwe staat volgens de transitiefunctie
+            currentState = it->second;
         }
-        // Als er een transitiefunctie bestaat dan verander je de
-        // current staat naar de nieuwe staat volgens de transitiefunctie
-        currentState = transitionFunction[{currentState, c}];
     }
     // zoek of we uiteindelijk in een accept state zijn belandt
     return find(acceptStates.begin(), acceptStates.end(), currentState) != acceptStates.end();
 }
 
 void DFA::print() {
-    // manueel aanmaken
-    json j;
-    // type
-    j["type"] = "DFA";
-
-    // alphabet
-    vector<string> alphabetString;
-    for (char c : alfabet) {
-        alphabetString.push_back(string(1, c));
-    }
-    j["alphabet"] = alphabetString;
+    print(cout);
+    cout << endl;
+}
 
-    // states
-    json states_array = json::array();
-    for (const auto& state : states) {
-        json state_obj;
-        state_obj["name"] = state;
-        state_obj["starting"] = (state == startState);
-        state_obj["accepting"] = (find(acceptStates.begin(), acceptStates.end(), state) != acceptStates.end());
-        states_array.push_back(state_obj);
-    }
-    j["states"] = states_array;
+void DFA::print(ostream &output, bool compact) const {
+    writeDFAJson(*this, output, compact);
+}
 
-    // transitions
-    json transitions_array = json::array();
-    for (const auto& transition : transitionFunction) {
-        json transition_obj;
-        transition_obj["from"] = transition.first.first;
-        transition_obj["input"] = string(1, transition.first.second);
-        transition_obj["to"] = transition.second;
-        transitions_array.push_back(transition_obj);
-    }
-    j["transitions"] = transitions_array;
+void DFA::writeBinary(const string &outputFile) const {
+    writeBinaryDFA(CompiledDFA(*this), outputFile);
+}
 
-    // Print JSON object
-    cout << setw(4) << j << endl;
+DFA DFA::readBinary(const string &inputFile) {
+    return readBinaryDFA(inputFile).toDFA();
 }
 
 vector<string> getDFAStatesFromString(const string& state_string) {
@@ -250,10 +270,85 @@ string getStringFromDFAStates(const vector<string>& states) {
 
 
 
-DFA DFA::minimize() {
-    // Construeer de tabel
-    constructTable(*this);
+DFA DFA::trim(pmr::memory_resource *scratch) const {
+    return CompiledDFA(*this).trim(true, scratch).toDFA();
+}
+
+DFA DFA::minimize(pmr::memory_resource *scratch) {
+    TraceSpan span("minimize");
+    TFA_STATS_TIMER(minimizeNanos);
+    TFA_STATS_ADD(minimizations, 1);
+#ifdef TFA_ENABLE_STATS
+    CountingResource counted(scratch);
+    scratch = &counted;
+#endif
+    shared_ptr<const MinimizationCache> cache = MinimizationCache::getDefault();
+    if (!cache) {
+        return minimizeWithTable(scratch);
+    }
+    // De sleutel hangt af van de invoer, bereken hem voor minimizeWithTable() de staten sorteert
+    Fingerprint key;
+    DFA minimized;
+    {
+        TFA_STATS_TIMER(cacheNanos);
+        key = MinimizationCache::keyFor(*this);
+        if (cache->lookup(key, minimized)) {
+            TFA_STATS_ADD(cacheHits, 1);
+            return minimized;
+        }
+    }
+    minimized = minimizeWithTable(scratch);
+    cache->store(key, minimized);
+    return minimized;
+}
+
+DFA DFA::minimizeWithTable(pmr::memory_resource *scratch) {
+    // Verwijder eerst onbereikbare en dode staten, de kwadratische tabel hoeft die niet te betalen
+    DFA trimmed;
+    {
+        TFA_STATS_TIMER(trimNanos);
+        trimmed = trim(scratch);
+    }
+    if (trimmed.getStates().size() < states.size()) {
+        TFA_STATS_ADD(trimmedStates, states.size() - trimmed.getStates().size());
+        return trimmed.minimizeWithTable(scratch);
+    }
 
+    // Het quotiënt hieronder volgt elke transitie: vul een partiële DFA aan met een put en laat
+    // die achteraf weer weg
+    bool complete = true;
+    for (const auto &state : states) {
+        for (char c : alfabet) {
+            complete = complete && transitionFunction.count({state, c}) > 0;
+        }
+    }
+    if (!complete) {
+        string sink = "{}";
+        while (find(states.begin(), states.end(), sink) != states.end()) {
+            sink += "'";
+        }
+        DFA completed = *this;
+        completed.addState(sink);
+        uint64_t completedTransitions = 0;
+        for (const auto &state : completed.getStates()) {
+            for (char c : alfabet) {
+                if (transitionFunction.count({state, c}) == 0) {
+                    completed.addTransition(state, c, sink);
+                    ++completedTransitions;
+                }
+            }
+        }
+        TFA_STATS_ADD(completedTransitions, completedTransitions);
+        return CompiledDFA(completed.minimizeWithTable(scratch)).trim(false, scratch).toDFA();
+    }
+
+    // Construeer de tabel (als die er nog niet is)
+    if (!tableValid) {
+        constructTable(*this, scratch);
+    }
+
+    TraceSpan quotient("quotient");
+    TFA_STATS_TIMER(quotientNanos);
     DFA newDFA;
 
     string alfabetString;
@@ -270,7 +365,7 @@ DFA DFA::minimize() {
             // check if transition is not marked as true
             if (!table[i][j]) {
                 // find source states for this transition
-                vector<string> dfaStates = this->getStates();
+                const vector<string> &dfaStates = this->getStates();
                 vector<string> statePair;
                 statePair.push_back(dfaStates[j]);
                 statePair.push_back(dfaStates[i+1]);
@@ -317,6 +412,9 @@ DFA DFA::minimize() {
 
     // Stap 2: Initialiseer de wachtrij met alle staten van de NFA
     queue<string> stateQueue;
+    // Een klasse staat hoogstens één keer in de wachtrij: een tweede keer verwerken levert dezelfde
+    // transities op, maar kopieert wel haar (mogelijk lange) naam voor elke transitie ernaartoe
+    set<string> queuedStates;
     if (!startStateAdded) {
         stateQueue.push("{"+this->getStartState()+"}");
         newDFA.setStartState("{"+this->getStartState()+"}");
@@ -347,14 +445,15 @@ DFA DFA::minimize() {
                 if (!dfaTransition.empty()) {
                     newDFA.addTransition(getStringFromDFAStates(dfaStates), c, getStringFromDFAStates(dfaTransition));
                     // b'' Kijkt in de verzameling van states indien de "to" State al verwerkt is
-                    if (find(processedStates.begin(), processedStates.end(), getStringFromDFAStates(dfaTransition)) == processedStates.end()) {
+                    if (find(processedStates.begin(), processedStates.end(), getStringFromDFAStates(dfaTransition)) == processedStates.end() &&
+                        queuedStates.insert(getStringFromDFAStates(dfaTransition)).second) {
                         stateQueue.push(getStringFromDFAStates(dfaTransition));
                     }
                 }
             }
         }
         // c. Markeer de huidige toestand als verwerkt en voeg dazn ook toe aan de staten van de DFA als deze nog niet bestaat natuurlijk
-        vector<string> dfaState = newDFA.getStates();
+        const vector<string> &dfaState = newDFA.getStates();
         if (find(dfaState.begin(), dfaState.end(), getStringFromDFAStates(dfaStates)) == dfaState.end()) {
             newDFA.addState(getStringFromDFAStates(dfaStates));
         }
@@ -377,6 +476,7 @@ DFA DFA::minimize() {
         }
     }
     newDFA.setAcceptStates(dfaAcceptStates);
+    TFA_STATS_ADD(quotientStates, newDFA.getStates().size());
 
 
     return newDFA;
@@ -384,6 +484,7 @@ DFA DFA::minimize() {
 }
 
 void DFA::printTable() {
+    getTable();
     for (int i = 1; i < states.size(); ++i) {
         cout << states[i];
         for (int j = 0; j <= i-1; ++j) {
@@ -406,10 +507,12 @@ void DFA::printTable() {
 // Setters
 void DFA::setStates(const vector<string> &states) {
     DFA::states = states;
+    tableValid = false;
 }
 
 void DFA::addState(const std::string &state) {
     DFA::states.push_back(state);
+    tableValid = false;
 }
 
 void DFA::setAlfabet(const string &alfabet) {
@@ -418,22 +521,27 @@ void DFA::setAlfabet(const string &alfabet) {
         chars.push_back(alfabet[i]);
     }
     DFA::alfabet = chars;
+    tableValid = false;
 }
 
 void DFA::setTransitionFunction(const map<pair<string, char>, string> &transitionFunction) {
     DFA::transitionFunction = transitionFunction;
+    tableValid = false;
 }
 
 void DFA::addTransition(const string &fromState, const char &input, const string &toState) {
     DFA::transitionFunction[{fromState, input}] = toState;
+    tableValid = false;
 }
 
 void DFA::setStartState(const string &startState) {
     DFA::startState = startState;
+    tableValid = false;
 }
 
 void DFA::setAcceptStates(const vector<string> &acceptStates) {
     DFA::acceptStates = acceptStates;
+    tableValid = false;
 }
 
 const vector<string> &DFA::getStates() const {
@@ -452,6 +560,7 @@ const vector<string> &DFA::getAcceptStates() const {
 
 void DFA::setTable(const vector<vector<bool>> &table) {
     DFA::table = table;
+    tableValid = true;
 }
 
 bool DFA::isAcceptingState(const std::string &state) const {
@@ -462,11 +571,63 @@ const string &DFA::getStartState() const {
     return startState;
 }
 
-const vector<vector<bool>> &DFA::getTable() const {
+const vector<vector<bool>> &DFA::getTable() {
+    if (!tableValid) {
+        constructTable(*this);
+    }
     return table;
 }
 
-bool operator==(DFA &dfa1, DFA &dfa2) {
+bool DFA::hasTable() const {
+    return tableValid;
+}
+
+void DFA::releaseTable() {
+    vector<vector<bool>>().swap(table);
+    tableValid = false;
+}
+
+// Heapgeheugen van een string buiten het object zelf (0 bij de small string optimization)
+static size_t heapBytes(const string &value) {
+    const char *object = reinterpret_cast<const char *>(&value);
+    bool local = value.data() >= object && value.data() < object + sizeof(value);
+    return local ? 0 : value.capacity() + 1;
+}
+
+static size_t heapBytes(const vector<string> &values) {
+    size_t bytes = values.capacity() * sizeof(string);
+    for (const auto &value : values) {
+        bytes += heapBytes(value);
+    }
+    return bytes;
+}
+
+MemoryUsage DFA::memoryUsage() const {
+    // Knoop van een std::map: kleur, ouder, links en rechts voor de waarde
+    const size_t mapNodeOverhead = 4 * sizeof(void *);
+
+    MemoryUsage usage;
+    usage.names = heapBytes(states) + heapBytes(acceptStates) + heapBytes(startState);
+    usage.transitions = transitionFunction.size() * (mapNodeOverhead + sizeof(*transitionFunction.begin()));
+    for (const auto &transition : transitionFunction) {
+        usage.names += heapBytes(transition.first.first) + heapBytes(transition.second);
+    }
+    usage.table = table.capacity() * sizeof(vector<bool>);
+    for (const auto &row : table) {
+        usage.table += (row.capacity() + 63) / 64 * sizeof(uint64_t);
+    }
+    usage.indices = alfabet.capacity();
+    return usage;
+}
+
+static bool equalsWithTable(DFA &lhs, DFA &rhs, pmr::memory_resource *scratch, bool print) {
+    // Alle tijdelijke buffers in één arena, in één keer vrijgegeven
+    pmr::monotonic_buffer_resource arena(scratch);
+
+    // Onbereikbare en dode staten doen niet mee in de tabel
+    DFA dfa1 = lhs.trim(&arena);
+    DFA dfa2 = rhs.trim(&arena);
+
     // Maak een table DFA aan
     // 1. Voeg de DFA's samen
     // Alfabet
@@ -524,9 +685,11 @@ bool operator==(DFA &dfa1, DFA &dfa2) {
         tableDFA.addTransition(transition.first.first, transition.first.second, transition.second);
     }
 
-    tableDFA.constructTable(tableDFA);
+    tableDFA.constructTable(tableDFA, &arena);
 
-    tableDFA.printTable();
+    if (print) {
+        tableDFA.printTable();
+    }
 
     pair<string, string> startStatesTableDFA  = {dfa1.getStartState(), dfa2.getStartState()};
     pair<int, int> indexesStartstates = tableDFA.getIndexesForStatePair(startStatesTableDFA, tableDFA.getStates());
@@ -538,4 +701,28 @@ bool operator==(DFA &dfa1, DFA &dfa2) {
         }
     }
     return false;
-}
\ No newline at end of file
+}
+
+bool operator==(DFA &lhs, DFA &rhs) {
+    return equalsWithTable(lhs, rhs, pmr::get_default_resource(), true);
+}
+
+bool DFA::equals(DFA &other, pmr::memory_resource *scratch) {
+    return equalsWithTable(*this, other, scratch, false);
+}
+
+bool DFA::isSubsetOf(const DFA &other, string &witness) const {
+    return CompiledDFA(*this).isSubsetOf(CompiledDFA(other), witness);
+}
+
+bool DFA::intersectionIsEmpty(const DFA &other, string &witness) const {
+    return CompiledDFA(*this).intersectionIsEmpty(CompiledDFA(other), witness);
+}
+
+bool DFA::isEmpty(string &witness) const {
+    return CompiledDFA(*this).isEmpty(witness);
+}
+
+Fingerprint DFA::fingerprint() const {
+    return CompiledDFA(*this).fingerprint();
+}
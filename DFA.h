@@ -9,6 +9,9 @@
 #include <vector>
 #include <map>
 #include <iostream>
+#include <memory_resource>
+#include "Fingerprint.h"
+#include "MemoryUsage.h"
 
 using namespace std;
 
@@ -21,7 +24,12 @@ private:
     string startState;
     vector<string> acceptStates;
 
+    // De tabel wordt pas opgebouwd wanneer ze nodig is, en vervalt bij elke setter
     vector<vector<bool>> table;
+    bool tableValid = false;
+
+    // minimize() zonder de cache
+    DFA minimizeWithTable(pmr::memory_resource *scratch);
 
 public:
     // Default constructor
@@ -32,14 +40,31 @@ public:
     bool accepts(string input);
 
     void print();
+    // Streams the JSON without building a DOM, optionally without indentation (see JsonWriter.h)
+    void print(ostream &output, bool compact = false) const;
+
+    // Binary format (see BinaryDFA.h), the counterpart of print() and the JSON constructor
+    void writeBinary(const string &outputFile) const;
+    static DFA readBinary(const string &inputFile);
 
-    DFA minimize();
+    // Checks MinimizationCache::getDefault() first when a cache directory is configured.
+    // Temporary buffers (trim, the table construction) come from scratch, e.g. a monotonic arena.
+    DFA minimize(pmr::memory_resource *scratch = pmr::get_default_resource());
+
+    // Kopie zonder onbereikbare en dode staten (dode staten worden samengevoegd tot één put)
+    DFA trim(pmr::memory_resource *scratch = pmr::get_default_resource()) const;
 
     void printTable();
 
+    // Frees the cached table (n^2 / 2 bits); getTable() rebuilds it when needed
+    void releaseTable();
+
+    // Heap bytes of this automaton, see MemoryUsage.h
+    MemoryUsage memoryUsage() const;
+
     pair<int, int> getIndexesForStatePair(pair<string, string>& statePair, const vector<string>& states);
 
-    vector<vector<bool>> constructTable(DFA& dfa);
+    vector<vector<bool>> constructTable(DFA& dfa, pmr::memory_resource *scratch = pmr::get_default_resource());
 
     // Setters
     void setStates(const vector<string> &states);
@@ -64,9 +89,22 @@ public:
 
     const string &getStartState() const;
 
-    const vector<vector<bool>> &getTable() const;
+    // Builds the table on first use (constructTable sorts the states); cached until a setter runs
+    const vector<vector<bool>> &getTable();
+    bool hasTable() const;
 
     friend bool operator==(DFA& lhs, DFA& rhs);
+    // operator== without printing the table, temporary buffers from scratch
+    bool equals(DFA &other, pmr::memory_resource *scratch = pmr::get_default_resource());
+
+    // Language inclusion and emptiness, explored on the fly without building a table.
+    // Bij false bevat witness het eerste (kortste) tegenvoorbeeld.
+    bool isSubsetOf(const DFA &other, string &witness) const;
+    bool intersectionIsEmpty(const DFA &other, string &witness) const;
+    bool isEmpty(string &witness) const;
+
+    // Fingerprint of the canonical minimal automaton: equal exactly when the languages are equal
+    Fingerprint fingerprint() const;
 
 };
 
@@ -0,0 +1,222 @@
+//
+// Client of DFAServer over a UNIX socket.
+//
+
+#include "DFAClient.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+using namespace std;
+
+DFAClient::DFAClient(const string &socketPath) : fd(-1), nextId(1) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+        throw runtime_error("invalid socket path " + socketPath);
+    }
+    memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1 || connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == -1) {
+        string error = "cannot connect to " + socketPath + ": " + strerror(errno);
+        if (fd != -1) {
+            close(fd);
+        }
+        throw runtime_error(error);
+    }
+}
+
+DFAClient::~DFAClient() {
+    close(fd);
+}
+
+FrameWriter DFAClient::startRequest(ServerOp op, uint32_t &id) {
+    id = nextId++;
+    FrameWriter request;
+    request.putUint8(uint8_t(op));
+    request.putUint32(id);
+    return request;
+}
+
+bool DFAClient::receiveResponse(uint32_t &id, string &payload) {
+    string frame;
+    if (!receiveFrame(fd, frame)) {
+        throw runtime_error("the server closed the connection");
+    }
+    FrameReader reader(frame);
+    ServerStatus status = ServerStatus(reader.getUint8());
+    id = reader.getUint32();
+    if (status != ServerStatus::Ok) {
+        payload = reader.getString();
+        return false;
+    }
+    payload = frame.substr(5);
+    return true;
+}
+
+string DFAClient::call(FrameWriter &request, uint32_t id) {
+    const string &frame = request.finish();
+    if (!sendAll(fd, frame.data(), frame.size())) {
+        throw runtime_error(string("cannot send to the server: ") + strerror(errno));
+    }
+    uint32_t responseId;
+    string payload;
+    bool ok = receiveResponse(responseId, payload);
+    if (responseId != id) {
+        throw runtime_error("response for another request");
+    }
+    if (!ok) {
+        throw runtime_error(payload);
+    }
+    return payload;
+}
+
+static pair<uint32_t, uint32_t> readStateCounts(const string &payload) {
+    FrameReader reader(payload);
+    uint32_t states = reader.getUint32();
+    return {states, reader.getUint32()};
+}
+
+pair<uint32_t, uint32_t> DFAClient::loadFile(const string &name, const string &path, bool jit) {
+    uint32_t id;
+    FrameWriter request = startRequest(ServerOp::Load, id);
+    request.putString(name);
+    request.putUint8(loadFromFile);
+    request.putString(path);
+    request.putUint8(jit ? loadJit : 0);
+    return readStateCounts(call(request, id));
+}
+
+pair<uint32_t, uint32_t> DFAClient::loadJson(const string &name, const string &document, bool jit) {
+    uint32_t id;
+    FrameWriter request = startRequest(ServerOp::Load, id);
+    request.putString(name);
+    request.putUint8(loadFromJson);
+    request.putString(document);
+    request.putUint8(jit ? loadJit : 0);
+    return readStateCounts(call(request, id));
+}
+
+bool DFAClient::unload(const string &name) {
+    uint32_t id;
+    FrameWriter request = startRequest(ServerOp::Unload, id);
+    request.putString(name);
+    return FrameReader(call(request, id)).getUint8() != 0;
+}
+
+vector<bool> DFAClient::accepts(const string &name, const vector<string> &inputs) {
+    uint32_t id;
+    FrameWriter request = startRequest(ServerOp::Accepts, id);
+    request.putString(name);
+    request.putUint32(uint32_t(inputs.size()));
+    for (const auto &input : inputs) {
+        request.putString(input);
+    }
+    string payload = call(request, id);
+    FrameReader reader(payload);
+    vector<bool> results;
+    results.reserve(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        results.push_back(reader.getUint8() != 0);
+    }
+    return results;
+}
+
+vector<vector<bool>> DFAClient::acceptsPipelined(const vector<pair<string, vector<string>>> &requests,
+                                                 size_t window) {
+    vector<vector<bool>> results(requests.size());
+    window = max<size_t>(window, 1);
+    for (size_t first = 0; first < requests.size(); first += window) {
+        size_t last = min(requests.size(), first + window);
+        // Een venster in één keer versturen, dan alle antwoorden lezen: zo wachten client en
+        // server nooit allebei tot de ander leest
+        string frames;
+        uint32_t firstId = nextId;
+        for (size_t i = first; i < last; ++i) {
+            uint32_t id;
+            FrameWriter request = startRequest(ServerOp::Accepts, id);
+            request.putString(requests[i].first);
+            request.putUint32(uint32_t(requests[i].second.size()));
+            for (const auto &input : requests[i].second) {
+                request.putString(input);
+            }
+            frames += request.finish();
+        }
+        if (!sendAll(fd, frames.data(), frames.size())) {
+            throw runtime_error(string("cannot send to the server: ") + strerror(errno));
+        }
+
+        string error;
+        for (size_t received = first; received < last; ++received) {
+            uint32_t id;
+            string payload;
+            bool ok = receiveResponse(id, payload);
+            // Antwoorden van verschillende batches kunnen in een andere volgorde komen
+            if (id - firstId >= last - first) {
+                throw runtime_error("response for another request");
+            }
+            size_t index = first + (id - firstId);
+            if (!ok) {
+                if (error.empty()) {
+                    error = payload;
+                }
+                continue;
+            }
+            FrameReader reader(payload);
+            results[index].reserve(requests[index].second.size());
+            for (size_t i = 0; i < requests[index].second.size(); ++i) {
+                results[index].push_back(reader.getUint8() != 0);
+            }
+        }
+        if (!error.empty()) {
+            throw runtime_error(error);
+        }
+    }
+    return results;
+}
+
+string DFAClient::minimize(const string &name) {
+    uint32_t id;
+    FrameWriter request = startRequest(ServerOp::Minimize, id);
+    request.putString(name);
+    string payload = call(request, id);
+    return string(FrameReader(payload).getString());
+}
+
+bool DFAClient::equivalent(const string &name, const string &other, string &witness, bool &otherAccepts) {
+    uint32_t id;
+    FrameWriter request = startRequest(ServerOp::Equivalence, id);
+    request.putString(name);
+    request.putString(other);
+    string payload = call(request, id);
+    FrameReader reader(payload);
+    bool equivalent = reader.getUint8() != 0;
+    witness = reader.getString();
+    otherAccepts = reader.getUint8() != 0;
+    return equivalent;
+}
+
+string DFAClient::job(const string &line) {
+    uint32_t id;
+    FrameWriter request = startRequest(ServerOp::Job, id);
+    request.putString(line);
+    string payload = call(request, id);
+    return string(FrameReader(payload).getString());
+}
+
+vector<pair<string, uint32_t>> DFAClient::list() {
+    uint32_t id;
+    FrameWriter request = startRequest(ServerOp::List, id);
+    string payload = call(request, id);
+    FrameReader reader(payload);
+    vector<pair<string, uint32_t>> automata(reader.getUint32());
+    for (auto &automaton : automata) {
+        automaton.first = reader.getString();
+        automaton.second = reader.getUint32();
+    }
+    return automata;
+}
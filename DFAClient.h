@@ -0,0 +1,60 @@
+//
+// Client of DFAServer over a UNIX socket.
+//
+
+#ifndef TABLEFILLINGALGORITHM_DFACLIENT_H
+#define TABLEFILLINGALGORITHM_DFACLIENT_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ServerProtocol.h"
+
+using namespace std;
+
+
+// Every call except acceptsPipelined() sends one request and waits for its response; errors of
+// the server are thrown as runtime_error with the server's message. Not thread-safe, give every
+// thread its own client. The server only batches requests that arrive together on one
+// connection, so one request per call never gets batched; acceptsPipelined() sends many
+// requests before reading the responses.
+class DFAClient {
+private:
+    int fd;
+    uint32_t nextId;
+
+    // Stuurt de frame en geeft de payload van het antwoord, na status en id
+    string call(FrameWriter &request, uint32_t id);
+    // Volgende antwoord; false met de foutmelding in payload als de server een fout meldt
+    bool receiveResponse(uint32_t &id, string &payload);
+    FrameWriter startRequest(ServerOp op, uint32_t &id);
+
+public:
+    explicit DFAClient(const string &socketPath);
+    ~DFAClient();
+
+    DFAClient(const DFAClient &) = delete;
+    DFAClient &operator=(const DFAClient &) = delete;
+
+    // Number of states of the automaton and of its minimal form
+    pair<uint32_t, uint32_t> loadFile(const string &name, const string &path, bool jit = false);
+    pair<uint32_t, uint32_t> loadJson(const string &name, const string &document, bool jit = false);
+    bool unload(const string &name);
+    vector<bool> accepts(const string &name, const vector<string> &inputs);
+    // Many Accepts requests (automaton name, inputs) with at most window of them unanswered, so
+    // the server can run them in batches; results in the order of requests. Throws the first
+    // error after all responses of the window have been read.
+    vector<vector<bool>> acceptsPipelined(const vector<pair<string, vector<string>>> &requests,
+                                          size_t window = 64);
+    // The minimal automaton in the BinaryDFA format
+    string minimize(const string &name);
+    // When false, witness is accepted by exactly one of them, by other when otherAccepts
+    bool equivalent(const string &name, const string &other, string &witness, bool &otherAccepts);
+    // A JobRunner job line, the result line
+    string job(const string &line);
+    vector<pair<string, uint32_t>> list();
+};
+
+
+#endif //TABLEFILLINGALGORITHM_DFACLIENT_H
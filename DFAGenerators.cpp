@@ -0,0 +1,212 @@
+//
+// Parameterized families of synthetic automata, for benchmarks and randomized checks.
+//
+
+#include "DFAGenerators.h"
+#include <cmath>
+#include <random>
+#include <stdexcept>
+using namespace std;
+
+// Uniform in [0, bound) zonder uniform_int_distribution, waarvan de uitvoer per standaardbibliotheek
+// verschilt (Lemire: vermenigvuldigen en de scheve rest verwerpen)
+static uint64_t bounded(mt19937_64 &rng, uint64_t bound) {
+    unsigned __int128 product = (unsigned __int128) rng() * bound;
+    uint64_t low = uint64_t(product);
+    if (low < bound) {
+        uint64_t threshold = -bound % bound;
+        while (low < threshold) {
+            product = (unsigned __int128) rng() * bound;
+            low = uint64_t(product);
+        }
+    }
+    return uint64_t(product >> 64);
+}
+
+static CompiledDFA withStates(const string &alfabet, uint32_t stateCount) {
+    CompiledDFA dfa;
+    for (char c : alfabet) {
+        dfa.addSymbol(c);
+    }
+    dfa.reserveStates(stateCount);
+    for (uint32_t state = 0; state < stateCount; ++state) {
+        dfa.addState(to_string(state));
+    }
+    if (stateCount > 0) {
+        dfa.setStartState(0);
+    }
+    return dfa;
+}
+
+static string firstSymbols(uint32_t symbolCount) {
+    if (symbolCount == 0 || symbolCount > 26) {
+        throw invalid_argument("symbolCount must be between 1 and 26");
+    }
+    string alfabet;
+    for (uint32_t symbol = 0; symbol < symbolCount; ++symbol) {
+        alfabet += char('a' + symbol);
+    }
+    return alfabet;
+}
+
+CompiledDFA randomCompleteDFA(uint32_t stateCount, uint32_t symbolCount, uint64_t seed) {
+    CompiledDFA dfa = withStates(firstSymbols(symbolCount), stateCount);
+    mt19937_64 rng(seed);
+    for (uint32_t state = 0; state < stateCount; ++state) {
+        dfa.setAccepting(state, rng() & 1);
+        for (uint32_t symbol = 0; symbol < symbolCount; ++symbol) {
+            dfa.setTransition(state, symbol, bounded(rng, stateCount));
+        }
+    }
+    return dfa;
+}
+
+CompiledDFA chainDFA(uint32_t stateCount) {
+    CompiledDFA dfa = withStates("a", stateCount);
+    for (uint32_t state = 0; state + 1 < stateCount; ++state) {
+        dfa.setTransition(state, 0, state + 1);
+    }
+    if (stateCount > 0) {
+        dfa.setAccepting(stateCount - 1, true);
+    }
+    return dfa;
+}
+
+CompiledDFA binaryCounterDFA(uint32_t stateCount) {
+    CompiledDFA dfa = withStates("01", stateCount);
+    for (uint32_t state = 0; state < stateCount; ++state) {
+        dfa.setTransition(state, 0, (2 * uint64_t(state)) % stateCount);
+        dfa.setTransition(state, 1, (2 * uint64_t(state) + 1) % stateCount);
+    }
+    if (stateCount > 0) {
+        dfa.setAccepting(0, true);
+    }
+    return dfa;
+}
+
+CompiledDFA hopcroftWorstCaseDFA(uint32_t stateCount) {
+    // Fibonacci-woord via het morfisme 0 -> 01, 1 -> 0
+    string word = "0";
+    while (word.size() < stateCount) {
+        string next;
+        for (char c : word) {
+            next += c == '0' ? "01" : "0";
+        }
+        word = move(next);
+    }
+
+    CompiledDFA dfa = withStates("a", stateCount);
+    for (uint32_t state = 0; state < stateCount; ++state) {
+        dfa.setTransition(state, 0, (state + 1) % stateCount);
+        dfa.setAccepting(state, word[state] == '1');
+    }
+    return dfa;
+}
+
+CompiledDFA lexerLikeDFA(uint32_t stateCount, uint64_t seed) {
+    const string alfabet = "abcdefghijklmnopqrstuvwxyz0123456789_";
+    CompiledDFA dfa;
+    for (char c : alfabet) {
+        dfa.addSymbol(c);
+    }
+    if (stateCount == 0) {
+        return dfa;
+    }
+    dfa.reserveStates(stateCount);
+    dfa.setStartState(dfa.addState("0"));
+
+    mt19937_64 rng(seed);
+    while (dfa.getStateCount() < stateCount) {
+        // Sleutelwoorden van 2 tot 10 tekens, de eerste letter uit een klein deel van het
+        // alfabet zodat ze prefixen delen
+        size_t length = 2 + bounded(rng, 9);
+        uint32_t state = dfa.getStartState();
+        for (size_t i = 0; i < length && dfa.getStateCount() < stateCount; ++i) {
+            int symbol = i == 0 ? bounded(rng, 8) : bounded(rng, alfabet.size());
+            uint32_t to = dfa.getTransition(state, symbol);
+            if (to == CompiledDFA::deadState) {
+                to = dfa.addState(to_string(dfa.getStateCount()));
+                dfa.setTransition(state, symbol, to);
+            }
+            state = to;
+        }
+        dfa.setAccepting(state, true);
+    }
+    return dfa;
+}
+
+CompiledDFA uniformAccessibleDFA(uint32_t stateCount, uint32_t symbolCount, uint64_t seed, uint32_t tolerance) {
+    string alfabet = firstSymbols(symbolCount);
+    if (stateCount == 0) {
+        return withStates(alfabet, 0);
+    }
+    // Het bereikbare deel van een willekeurige DFA met m staten heeft er ongeveer v * m, met
+    // v = 1 - e^(-kv) (Korshunov); conditioneel op de grootte is het uniform (Carayol, Nicaud)
+    double v = 1;
+    for (int i = 0; i < 100; ++i) {
+        v = 1 - exp(-double(symbolCount) * v);
+    }
+    uint64_t total = max<uint64_t>(stateCount, llround(stateCount / v));
+    uint64_t low = stateCount - min(stateCount, tolerance);
+    uint64_t high = uint64_t(stateCount) + tolerance;
+
+    mt19937_64 rng(seed);
+    vector<uint32_t> index(total, CompiledDFA::deadState);
+    vector<uint64_t> order;
+    vector<uint32_t> transitions;
+    while (true) {
+        // Breedte-eerst vanaf staat 0, de transities pas trekken als hun staat bereikt wordt;
+        // afbreken zodra het te groot wordt
+        order.assign(1, 0);
+        index[0] = 0;
+        transitions.clear();
+        for (size_t next = 0; next < order.size() && order.size() <= high; ++next) {
+            for (uint32_t symbol = 0; symbol < symbolCount; ++symbol) {
+                uint64_t to = bounded(rng, total);
+                if (index[to] == CompiledDFA::deadState) {
+                    index[to] = order.size();
+                    order.push_back(to);
+                }
+                transitions.push_back(index[to]);
+            }
+        }
+        for (uint64_t state : order) {
+            index[state] = CompiledDFA::deadState;
+        }
+        if (order.size() >= low && order.size() <= high) {
+            break;
+        }
+    }
+
+    CompiledDFA dfa = withStates(alfabet, order.size());
+    for (uint32_t state = 0; state < order.size(); ++state) {
+        dfa.setAccepting(state, rng() & 1);
+        for (uint32_t symbol = 0; symbol < symbolCount; ++symbol) {
+            dfa.setTransition(state, symbol, transitions[size_t(state) * symbolCount + symbol]);
+        }
+    }
+    return dfa;
+}
+
+const vector<string> &dfaFamilies() {
+    static const vector<string> families = {"random", "uniform", "chain", "counter", "hopcroft", "lexer"};
+    return families;
+}
+
+CompiledDFA generateFamily(const string &family, uint32_t stateCount, uint64_t seed) {
+    if (family == "random") {
+        return randomCompleteDFA(stateCount, 2, seed);
+    } else if (family == "uniform") {
+        // Exact duurt bij een miljoen staten minuten, op 0.1% na een fractie van een seconde
+        return uniformAccessibleDFA(stateCount, 2, seed, stateCount / 1000);
+    } else if (family == "chain") {
+        return chainDFA(stateCount);
+    } else if (family == "counter") {
+        return binaryCounterDFA(stateCount);
+    } else if (family == "hopcroft") {
+        return hopcroftWorstCaseDFA(stateCount);
+    } else if (family == "lexer") {
+        return lexerLikeDFA(stateCount, seed);
+    }
+    throw invalid_argument("unknown DFA family: " + family);
+}
@@ -0,0 +1,54 @@
+//
+// Parameterized families of synthetic automata, for benchmarks and randomized checks.
+//
+
+#ifndef TABLEFILLINGALGORITHM_DFAGENERATORS_H
+#define TABLEFILLINGALGORITHM_DFAGENERATORS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "CompiledDFA.h"
+
+using namespace std;
+
+
+// All generators are deterministic in their arguments. States are named by their index and the
+// alphabet is 'a', 'b', ... unless stated otherwise.
+
+// Every transition of every state goes to a uniformly chosen state, each state accepts with
+// probability 1/2. Complete, but not necessarily accessible or minimal.
+CompiledDFA randomCompleteDFA(uint32_t stateCount, uint32_t symbolCount, uint64_t seed);
+
+// 0 -a-> 1 -a-> ... -a-> stateCount-1, only the last state accepts: the language {a^(n-1)}
+CompiledDFA chainDFA(uint32_t stateCount);
+
+// Reads a binary number (alphabet '0', '1') and keeps its value modulo stateCount; accepts the
+// multiples of stateCount. Minimal for odd stateCount.
+CompiledDFA binaryCounterDFA(uint32_t stateCount);
+
+// Unary cycle whose accepting states follow the Fibonacci word, a known worst case for
+// Hopcroft's algorithm (Theta(n log n) refinements)
+CompiledDFA hopcroftWorstCaseDFA(uint32_t stateCount);
+
+// Keyword trie over printable ASCII, grown with random keywords until it has stateCount states:
+// few transitions per state and many equivalent leaves, like the automaton of a lexer
+CompiledDFA lexerLikeDFA(uint32_t stateCount, uint64_t seed);
+
+// Uniformly random among the accessible complete DFAs with stateCount states (up to renaming of
+// the states), every state accepting with probability 1/2. Samples the accessible part of a
+// uniform random DFA with about stateCount / 0.797 states (for two symbols) and rejects it until
+// it has exactly stateCount states; only reached states are generated, and the expected number
+// of attempts grows like sqrt(stateCount). A tolerance > 0 accepts any size within
+// stateCount +- tolerance, each size still uniform, which takes a few attempts at any size.
+// States are numbered in breadth-first order from the start state.
+CompiledDFA uniformAccessibleDFA(uint32_t stateCount, uint32_t symbolCount, uint64_t seed, uint32_t tolerance = 0);
+
+// Names accepted by generateFamily()
+const vector<string> &dfaFamilies();
+// One of the families above by name, with two symbols for "random" and "uniform" (the latter with
+// a tolerance of stateCount / 1000); invalid_argument otherwise
+CompiledDFA generateFamily(const string &family, uint32_t stateCount, uint64_t seed);
+
+
+#endif //TABLEFILLINGALGORITHM_DFAGENERATORS_H
@@ -0,0 +1,24 @@
+//
+// Matching words against a DFA with a selectable engine.
+//
+
+#include "DFAMatcher.h"
+using namespace std;
+
+DFAMatcher::DFAMatcher(CompiledDFA dfa, MatchEngine engine) : dfa(move(dfa)) {
+    if (engine == MatchEngine::Jit && JitMatcher::isSupported()) {
+        jit = make_unique<JitMatcher>(DFAMatcher::dfa);
+    }
+}
+
+bool DFAMatcher::accepts(string_view input) const {
+    return jit ? jit->accepts(input) : dfa.accepts(input);
+}
+
+MatchEngine DFAMatcher::getEngine() const {
+    return jit ? MatchEngine::Jit : MatchEngine::Table;
+}
+
+const CompiledDFA &DFAMatcher::getDFA() const {
+    return dfa;
+}
@@ -0,0 +1,42 @@
+//
+// Matching words against a DFA with a selectable engine.
+//
+
+#ifndef TABLEFILLINGALGORITHM_DFAMATCHER_H
+#define TABLEFILLINGALGORITHM_DFAMATCHER_H
+
+#include <memory>
+#include <string_view>
+#include "CompiledDFA.h"
+#include "JitMatcher.h"
+
+using namespace std;
+
+
+enum class MatchEngine {
+    // Walk over the transition table of CompiledDFA
+    Table,
+    // Native code from JitMatcher
+    Jit
+};
+
+// Owns the automaton and, for MatchEngine::Jit, its machine code. Where the JIT is not supported
+// the table walk is used instead; getEngine() tells which one runs. Both give the same answer
+// as CompiledDFA::accepts().
+class DFAMatcher {
+private:
+    CompiledDFA dfa;
+    unique_ptr<JitMatcher> jit;
+
+public:
+    explicit DFAMatcher(CompiledDFA dfa, MatchEngine engine = MatchEngine::Table);
+
+    bool accepts(string_view input) const;
+
+    // Getters
+    MatchEngine getEngine() const;
+    const CompiledDFA &getDFA() const;
+};
+
+
+#endif //TABLEFILLINGALGORITHM_DFAMATCHER_H
@@ -0,0 +1,447 @@
+//
+// Long-running server that keeps automata resident and answers requests over a UNIX socket.
+//
+
+#include "DFAServer.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <poll.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "BinaryDFA.h"
+#include "JsonLoader.h"
+#include "ServerProtocol.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+using namespace std;
+
+// Per verbinding: zoveel batches tegelijk in de pool, en boven zoveel onverzonden bytes wordt er
+// niet meer gelezen. Een client die niet leest, houdt zo enkel zijn eigen verbinding op.
+static const size_t maxBatchesInFlight = 4;
+static const size_t maxPendingOutput = 8 << 20;
+
+struct ServerConnection {
+    int fd;
+    // Gelezen bytes die nog geen volledige frame vormen (enkel de poll-thread)
+    string input;
+    // Einde van de invoer gezien; de verbinding blijft tot alle antwoorden verstuurd zijn
+    bool inputClosed = false;
+
+    // De rest onder lock, workers voegen hun antwoorden toe en de poll-thread verstuurt ze
+    mutex lock;
+    string output;
+    size_t batchesInFlight = 0;
+
+    explicit ServerConnection(int fd) : fd(fd) {}
+
+    ~ServerConnection() {
+        close(fd);
+    }
+};
+
+DFAServer::DFAServer(const string &socketPath, unsigned threadCount, size_t maxQueued, size_t maxBatch)
+        : socketPath(socketPath), threadCount(threadCount == 0 ? ThreadPool::defaultThreadCount() : threadCount),
+          maxQueued(maxQueued), maxBatch(maxBatch == 0 ? 1 : maxBatch), listenFd(-1), wakeFds{-1, -1},
+          stopping(false), resident(make_unique<const ResidentMap>()), lastVersion(0),
+          jobRunner([this](const string &name) {
+              // Eerst de residente automaten, anders een bestand
+              shared_ptr<const DFASnapshot> dfa = find(name);
+              return dfa ? shared_ptr<const CompiledDFA>(dfa, &dfa->getDFA()) : JobRunner::loadFile(name);
+          }) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+        throw runtime_error("invalid socket path " + socketPath);
+    }
+    memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+
+    // Een socket van een vorige server die niet netjes gestopt is, maar geen ander bestand
+    struct stat status;
+    if (stat(socketPath.c_str(), &status) == 0 && S_ISSOCK(status.st_mode)) {
+        unlink(socketPath.c_str());
+    }
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd == -1 || bind(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == -1 ||
+        listen(listenFd, SOMAXCONN) == -1 || pipe2(wakeFds, O_CLOEXEC | O_NONBLOCK) == -1) {
+        string error = "cannot listen on " + socketPath + ": " + strerror(errno);
+        if (listenFd != -1) {
+            close(listenFd);
+        }
+        throw runtime_error(error);
+    }
+}
+
+DFAServer::~DFAServer() {
+    close(listenFd);
+    unlink(socketPath.c_str());
+    close(wakeFds[0]);
+    close(wakeFds[1]);
+}
+
+void DFAServer::stop() {
+    stopping.store(true);
+    wake();
+}
+
+void DFAServer::wake() {
+    char byte = 0;
+    ssize_t ignored = write(wakeFds[1], &byte, 1);
+    (void) ignored;
+}
+
+// Leest wat er klaarstaat; false bij een fout, inputClosed bij het einde van de stroom
+static bool readConnection(ServerConnection &connection) {
+    // Een client die blijft schrijven mag de andere verbindingen niet uithongeren
+    const size_t maxReadPerPoll = 1 << 20;
+    char buffer[65536];
+    size_t readNow = 0;
+    while (readNow < maxReadPerPoll) {
+        ssize_t count = recv(connection.fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (count > 0) {
+            connection.input.append(buffer, count);
+            readNow += count;
+        } else if (count == 0) {
+            connection.inputClosed = true;
+            break;
+        } else if (errno == EINTR) {
+            continue;
+        } else {
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+    }
+    return true;
+}
+
+// Haalt hoogstens maxFrames volledige frames uit de invoer; false bij een te grote frame
+static bool takeFrames(ServerConnection &connection, size_t maxFrames, vector<string> &requests) {
+    size_t position = 0;
+    const string &input = connection.input;
+    bool valid = true;
+    while (requests.size() < maxFrames && input.size() - position >= 4) {
+        uint32_t length = uint8_t(input[position]) | uint8_t(input[position + 1]) << 8 |
+                          uint8_t(input[position + 2]) << 16 | uint32_t(uint8_t(input[position + 3])) << 24;
+        if (length > maxFrameSize) {
+            valid = false;
+            break;
+        }
+        if (input.size() - position - 4 < length) {
+            break;
+        }
+        requests.push_back(input.substr(position + 4, length));
+        position += 4 + length;
+    }
+    connection.input.erase(0, position);
+    return valid;
+}
+
+// Verstuurt zonder te blokkeren wat de workers klaargezet hebben; false als de client weg is
+static bool flushConnection(ServerConnection &connection) {
+    lock_guard<mutex> guard(connection.lock);
+    size_t sent = 0;
+    while (sent < connection.output.size()) {
+        ssize_t count = send(connection.fd, connection.output.data() + sent, connection.output.size() - sent,
+                             MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (count > 0) {
+            sent += count;
+        } else if (count < 0 && errno == EINTR) {
+            continue;
+        } else {
+            if (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                return false;
+            }
+            break;
+        }
+    }
+    connection.output.erase(0, sent);
+    return true;
+}
+
+void DFAServer::run() {
+    // Standaard twee batches per worker in de wachtrij, zoals de batch-CLI. De wachtrij loopt enkel
+    // vol als de workers rekenen: ze schrijven nooit zelf naar een socket en blokkeren dus niet.
+    ThreadPool pool(threadCount, maxQueued == 0 ? 2 * size_t(threadCount) : maxQueued);
+    vector<shared_ptr<ServerConnection>> connections;
+    vector<pollfd> fds;
+    while (!stopping.load()) {
+        // Eerst batches uit de invoer die al gelezen is, voor zover de verbinding nog ruimte heeft
+        size_t kept = 0;
+        for (auto &connection : connections) {
+            bool alive = true;
+            while (true) {
+                {
+                    lock_guard<mutex> guard(connection->lock);
+                    if (connection->batchesInFlight >= maxBatchesInFlight) {
+                        break;
+                    }
+                }
+                vector<string> batch;
+                alive = takeFrames(*connection, maxBatch, batch);
+                if (batch.empty()) {
+                    break;
+                }
+                {
+                    lock_guard<mutex> guard(connection->lock);
+                    ++connection->batchesInFlight;
+                }
+                pool.submit([this, connection, batch = move(batch)]() { runBatch(*connection, batch); });
+            }
+            bool finished;
+            {
+                lock_guard<mutex> guard(connection->lock);
+                finished = connection->inputClosed && connection->batchesInFlight == 0 && connection->output.empty();
+            }
+            // Een onvolledige frame na het einde van de invoer komt nooit meer aan
+            if (alive && !finished) {
+                connections[kept++] = move(connection);
+            }
+        }
+        connections.resize(kept);
+
+        fds.assign({{wakeFds[0], POLLIN, 0}, {listenFd, POLLIN, 0}});
+        for (const auto &connection : connections) {
+            short events = 0;
+            lock_guard<mutex> guard(connection->lock);
+            if (!connection->inputClosed && connection->batchesInFlight < maxBatchesInFlight &&
+                connection->output.size() < maxPendingOutput) {
+                events |= POLLIN;
+            }
+            if (!connection->output.empty()) {
+                events |= POLLOUT;
+            }
+            // Zonder events niet pollen: POLLHUP van een gesloten client zou poll() steeds wekken
+            fds.push_back({events == 0 ? -1 : connection->fd, events, 0});
+        }
+        if (poll(fds.data(), fds.size(), -1) == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw runtime_error(string("poll failed: ") + strerror(errno));
+        }
+        if (fds[0].revents != 0) {
+            // stop(), of een worker met nieuwe antwoorden
+            char bytes[64];
+            while (read(wakeFds[0], bytes, sizeof(bytes)) > 0) {
+            }
+        }
+        if (fds[1].revents & POLLIN) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd != -1) {
+                connections.push_back(make_shared<ServerConnection>(fd));
+            }
+        }
+
+        // fds[i + 2] hoort bij connections[i], nieuwe verbindingen komen pas bij de volgende poll aan bod
+        kept = 0;
+        for (size_t i = 0; i < connections.size(); ++i) {
+            shared_ptr<ServerConnection> connection = move(connections[i]);
+            bool alive = true;
+            if (i + 2 < fds.size()) {
+                short revents = fds[i + 2].revents;
+                if (revents & (POLLERR | POLLNVAL)) {
+                    alive = false;
+                }
+                if (alive && (revents & POLLIN)) {
+                    alive = readConnection(*connection);
+                }
+                if (alive && (revents & POLLHUP) && !(revents & POLLIN)) {
+                    connection->inputClosed = true;
+                }
+            }
+            // Ook zonder POLLOUT: de workers kunnen intussen antwoorden toegevoegd hebben
+            if (alive) {
+                alive = flushConnection(*connection);
+            }
+            // Batches die nog lopen houden een weggevallen verbinding in leven, hun antwoorden verdwijnen
+            if (alive) {
+                connections[kept++] = move(connection);
+            }
+        }
+        connections.resize(kept);
+    }
+    pool.wait();
+    // Wat al berekend is nog versturen, zonder op trage clients te wachten
+    for (const auto &connection : connections) {
+        flushConnection(*connection);
+    }
+}
+
+void DFAServer::runBatch(ServerConnection &connection, const vector<string> &requests) {
+    TraceSpan span("batch");
+    ResidentMap names;
+    string responses;
+    for (const auto &request : requests) {
+        responses += handleRequest(request, names);
+    }
+    {
+        lock_guard<mutex> guard(connection.lock);
+        connection.output += responses;
+        --connection.batchesInFlight;
+    }
+    // De poll-thread verstuurt de antwoorden en kan weer lezen
+    wake();
+}
+
+static void checkEnd(const FrameReader &reader) {
+    if (!reader.atEnd()) {
+        throw runtime_error("unexpected bytes after the arguments");
+    }
+}
+
+string DFAServer::handleRequest(string_view payload, ResidentMap &names) {
+    FrameReader reader(payload);
+    uint32_t id = 0;
+    auto lookup = [&](string_view name) {
+        auto found = names.find(name);
+        if (found != names.end()) {
+            return found->second;
+        }
+        shared_ptr<const DFASnapshot> dfa = find(name);
+        if (!dfa) {
+            throw runtime_error("no automaton named " + string(name));
+        }
+        names.emplace(string(name), dfa);
+        return dfa;
+    };
+
+    try {
+        ServerOp op = ServerOp(reader.getUint8());
+        id = reader.getUint32();
+        FrameWriter response;
+        response.putUint8(uint8_t(ServerStatus::Ok));
+        response.putUint32(id);
+        switch (op) {
+            case ServerOp::Load: {
+                string name(reader.getString());
+                uint8_t source = reader.getUint8();
+                string_view argument = reader.getString();
+                uint8_t flags = reader.getUint8();
+                checkEnd(reader);
+                CompiledDFA dfa;
+                if (source == loadFromFile) {
+                    dfa = readDFAFile(string(argument));
+                } else if (source == loadFromJson) {
+                    dfa = parseCompiledDFA(string(argument));
+                } else {
+                    throw runtime_error("unknown load source " + to_string(source));
+                }
+                shared_ptr<const DFASnapshot> loaded =
+                        load(name, move(dfa), flags & loadJit ? MatchEngine::Jit : MatchEngine::Table);
+                names[name] = loaded;
+                response.putUint32(loaded->getDFA().getStateCount());
+                response.putUint32(loaded->getMinimal().getStateCount());
+                break;
+            }
+            case ServerOp::Unload: {
+                string name(reader.getString());
+                checkEnd(reader);
+                names.erase(name);
+                response.putUint8(unload(name));
+                break;
+            }
+            case ServerOp::Accepts: {
+                shared_ptr<const DFASnapshot> dfa = lookup(reader.getString());
+                uint32_t count = reader.getUint32();
+                for (uint32_t i = 0; i < count; ++i) {
+                    response.putUint8(dfa->accepts(reader.getString()));
+                }
+                checkEnd(reader);
+                break;
+            }
+            case ServerOp::Minimize: {
+                shared_ptr<const DFASnapshot> dfa = lookup(reader.getString());
+                checkEnd(reader);
+                ostringstream binary;
+                writeBinaryDFA(dfa->getMinimal(), binary);
+                response.putString(binary.str());
+                break;
+            }
+            case ServerOp::Equivalence: {
+                shared_ptr<const DFASnapshot> dfa = lookup(reader.getString());
+                shared_ptr<const DFASnapshot> other = lookup(reader.getString());
+                checkEnd(reader);
+                // Op de minimale automaten, die zijn al berekend
+                string witness;
+                uint8_t side = 0;
+                bool equivalent = dfa->getMinimal().isSubsetOf(other->getMinimal(), witness);
+                if (equivalent) {
+                    side = 1;
+                    equivalent = other->getMinimal().isSubsetOf(dfa->getMinimal(), witness);
+                }
+                response.putUint8(equivalent);
+                response.putString(equivalent ? "" : witness);
+                response.putUint8(equivalent ? 0 : side);
+                break;
+            }
+            case ServerOp::Job: {
+                string job(reader.getString());
+                checkEnd(reader);
+                response.putString(jobRunner.run(job));
+                break;
+            }
+            case ServerOp::List: {
+                checkEnd(reader);
+                vector<pair<string, uint32_t>> automata = list();
+                response.putUint32(uint32_t(automata.size()));
+                for (const auto &automaton : automata) {
+                    response.putString(automaton.first);
+                    response.putUint32(automaton.second);
+                }
+                break;
+            }
+            default:
+                throw runtime_error("unknown op " + to_string(int(op)));
+        }
+        return move(response.finish());
+    } catch (const exception &e) {
+        FrameWriter error;
+        error.putUint8(uint8_t(ServerStatus::Error));
+        error.putUint32(id);
+        error.putString(e.what());
+        return move(error.finish());
+    }
+}
+
+shared_ptr<const DFASnapshot> DFAServer::load(const string &name, CompiledDFA dfa, MatchEngine engine) {
+    // Minimaliseren en de matcher bouwen voor er iets vervangen wordt, lezers gebruiken intussen de vorige versie
+    auto loaded = make_shared<const DFASnapshot>(move(dfa), engine, lastVersion.fetch_add(1) + 1);
+    resident.update([&](const ResidentMap *current) {
+        auto next = make_unique<ResidentMap>(*current);
+        (*next)[name] = loaded;
+        return unique_ptr<const ResidentMap>(move(next));
+    });
+    return loaded;
+}
+
+bool DFAServer::unload(const string &name) {
+    return resident.update([&](const ResidentMap *current) {
+        if (current->count(name) == 0) {
+            return unique_ptr<const ResidentMap>();
+        }
+        auto next = make_unique<ResidentMap>(*current);
+        next->erase(name);
+        return unique_ptr<const ResidentMap>(move(next));
+    });
+}
+
+shared_ptr<const DFASnapshot> DFAServer::find(string_view name) const {
+    EpochGuard guard;
+    const ResidentMap *automata = resident.load();
+    auto found = automata->find(name);
+    return found == automata->end() ? nullptr : found->second;
+}
+
+vector<pair<string, uint32_t>> DFAServer::list() const {
+    EpochGuard guard;
+    vector<pair<string, uint32_t>> automata;
+    for (const auto &entry : *resident.load()) {
+        automata.emplace_back(entry.first, entry.second->getDFA().getStateCount());
+    }
+    return automata;
+}
@@ -0,0 +1,85 @@
+//
+// Long-running server that keeps automata resident and answers requests over a UNIX socket.
+//
+
+#ifndef TABLEFILLINGALGORITHM_DFASERVER_H
+#define TABLEFILLINGALGORITHM_DFASERVER_H
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "CompiledDFA.h"
+#include "DFASnapshot.h"
+#include "EpochReclamation.h"
+#include "JobRunner.h"
+
+using namespace std;
+
+
+struct ServerConnection;
+
+// Speaks the protocol of ServerProtocol.h on a UNIX stream socket. One thread (the one that calls
+// run()) accepts connections and reads them with poll(); every complete frame it finds on a
+// connection becomes part of a batch, and batches of up to maxBatch requests run as one task on
+// a ThreadPool. A batch looks every name up once and hands all its responses back at once, so a
+// client that pipelines many small Accepts pays for the dispatch once per batch. Workers never
+// write to a socket: the polling thread sends the responses without blocking. Every connection
+// has at most a few batches in the pool, and the server stops reading from a connection whose
+// responses are not being read, so a client that only sends holds up its own connection and not
+// the others. The queue of the pool is bounded as well.
+//
+// The resident automata are DFASnapshots, loaded and minimized once. The map from names to
+// snapshots is itself immutable and published through a SnapshotPointer: Load and Unload build
+// the new snapshot and a copy of the map without holding anything the readers need, then swap the
+// map, so requests never lock and keep matching on the previous version during a reload. A batch
+// that looked a name up before the swap finishes on the old snapshot.
+class DFAServer {
+private:
+    string socketPath;
+    unsigned threadCount;
+    size_t maxQueued;
+    size_t maxBatch;
+    int listenFd;
+    // stop() schrijft een byte om poll() te wekken
+    int wakeFds[2];
+    atomic<bool> stopping;
+
+    typedef map<string, shared_ptr<const DFASnapshot>, less<>> ResidentMap;
+    SnapshotPointer<ResidentMap> resident;
+    atomic<uint64_t> lastVersion;
+    JobRunner jobRunner;
+
+    void runBatch(ServerConnection &connection, const vector<string> &requests);
+    // Wekt poll(), ook vanuit een signal handler
+    void wake();
+    // names onthoudt de opzoekingen van een batch
+    string handleRequest(string_view payload, ResidentMap &names);
+
+public:
+    // Binds and listens on socketPath (a stale socket file is replaced), throws runtime_error when
+    // that fails. threadCount 0 uses all cores, maxQueued 0 allows two batches per worker.
+    explicit DFAServer(const string &socketPath, unsigned threadCount = 0, size_t maxQueued = 0,
+                       size_t maxBatch = 64);
+    ~DFAServer();
+
+    DFAServer(const DFAServer &) = delete;
+    DFAServer &operator=(const DFAServer &) = delete;
+
+    // Serves until stop(); the batches that were read finish before it returns
+    void run();
+    // Only sets a flag and writes to a pipe, so it may be called from a signal handler
+    void stop();
+
+    // Same as the Load and Unload requests, for preloading in the server process
+    shared_ptr<const DFASnapshot> load(const string &name, CompiledDFA dfa, MatchEngine engine = MatchEngine::Table);
+    bool unload(const string &name);
+    // nullptr when there is no automaton with that name; never locks
+    shared_ptr<const DFASnapshot> find(string_view name) const;
+    vector<pair<string, uint32_t>> list() const;
+};
+
+
+#endif //TABLEFILLINGALGORITHM_DFASERVER_H
@@ -0,0 +1,70 @@
+//
+// Immutable compiled automata that can be replaced while other threads keep matching.
+//
+
+#include "DFASnapshot.h"
+#include <stdexcept>
+#include "Trace.h"
+using namespace std;
+
+DFASnapshot::DFASnapshot(CompiledDFA dfa, MatchEngine engine, uint64_t version)
+        : dfa(move(dfa)), minimal(this->dfa.minimize()), matcher(minimal, engine), version(version) {}
+
+bool DFASnapshot::accepts(string_view input) const {
+    return matcher.accepts(input);
+}
+
+const CompiledDFA &DFASnapshot::getDFA() const {
+    return dfa;
+}
+
+const CompiledDFA &DFASnapshot::getMinimal() const {
+    return minimal;
+}
+
+const DFAMatcher &DFASnapshot::getMatcher() const {
+    return matcher;
+}
+
+uint64_t DFASnapshot::getVersion() const {
+    return version;
+}
+
+PublishedDFA::PublishedDFA() : lastVersion(0) {}
+
+PublishedDFA::PublishedDFA(CompiledDFA dfa, MatchEngine engine) : lastVersion(0) {
+    publish(move(dfa), engine);
+}
+
+uint64_t PublishedDFA::publish(CompiledDFA dfa, MatchEngine engine) {
+    TraceSpan span("publish");
+    uint64_t version = lastVersion.fetch_add(1) + 1;
+    auto next = make_unique<const DFASnapshot>(move(dfa), engine, version);
+    // Twee gelijktijdige publish(): de hoogste versie wint, ook als die eerst klaar is
+    snapshot.update([&next](const DFASnapshot *current) -> unique_ptr<const DFASnapshot> {
+        if (current && current->getVersion() > next->getVersion()) {
+            return nullptr;
+        }
+        return move(next);
+    });
+    return version;
+}
+
+bool PublishedDFA::accepts(string_view input) const {
+    EpochGuard guard;
+    const DFASnapshot *current = snapshot.load();
+    if (!current) {
+        throw logic_error("no DFA has been published");
+    }
+    return current->accepts(input);
+}
+
+const DFASnapshot *PublishedDFA::load() const {
+    return snapshot.load();
+}
+
+uint64_t PublishedDFA::getVersion() const {
+    EpochGuard guard;
+    const DFASnapshot *current = snapshot.load();
+    return current ? current->getVersion() : 0;
+}
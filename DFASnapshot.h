@@ -0,0 +1,67 @@
+//
+// Immutable compiled automata that can be replaced while other threads keep matching.
+//
+
+#ifndef TABLEFILLINGALGORITHM_DFASNAPSHOT_H
+#define TABLEFILLINGALGORITHM_DFASNAPSHOT_H
+
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+#include "CompiledDFA.h"
+#include "DFAMatcher.h"
+#include "EpochReclamation.h"
+
+using namespace std;
+
+
+// One version of an automaton: the automaton as loaded, its minimal form and a matcher on the
+// minimal form, all built by the constructor and never changed afterwards, so any number of
+// threads can use it without synchronization.
+class DFASnapshot {
+private:
+    CompiledDFA dfa;
+    CompiledDFA minimal;
+    DFAMatcher matcher;
+    uint64_t version;
+
+public:
+    DFASnapshot(CompiledDFA dfa, MatchEngine engine = MatchEngine::Table, uint64_t version = 0);
+
+    bool accepts(string_view input) const;
+
+    // Getters
+    const CompiledDFA &getDFA() const;
+    const CompiledDFA &getMinimal() const;
+    const DFAMatcher &getMatcher() const;
+    uint64_t getVersion() const;
+};
+
+// The current DFASnapshot of a long-running matcher. publish() builds the next version on the
+// calling thread (loading and minimizing happen before anything is swapped) and then replaces
+// the pointer; accepts() never locks, it sees either the old or the new version, and the old one
+// is freed once the calls that use it have returned (see EpochReclamation.h).
+class PublishedDFA {
+private:
+    SnapshotPointer<DFASnapshot> snapshot;
+    atomic<uint64_t> lastVersion;
+
+public:
+    PublishedDFA();
+    explicit PublishedDFA(CompiledDFA dfa, MatchEngine engine = MatchEngine::Table);
+
+    // The version of the new snapshot, numbered from 1. When publishes overlap the highest version
+    // stays, even if an older one finishes after it.
+    uint64_t publish(CompiledDFA dfa, MatchEngine engine = MatchEngine::Table);
+
+    // Throws logic_error before the first publish()
+    bool accepts(string_view input) const;
+
+    // For several calls on the same version; only inside an EpochGuard, nullptr before the first publish()
+    const DFASnapshot *load() const;
+    // 0 before the first publish()
+    uint64_t getVersion() const;
+};
+
+
+#endif //TABLEFILLINGALGORITHM_DFASNAPSHOT_H
@@ -0,0 +1,154 @@
+//
+// Epoch-based reclamation and RCU-style publication of immutable objects.
+//
+
+#include "EpochReclamation.h"
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// Epoch van een thread die niet in een guard zit
+static const uint64_t idleEpoch = UINT64_MAX;
+
+struct EpochRecord {
+    // Globale epoch bij het binnengaan van de buitenste guard, idleEpoch erbuiten
+    atomic<uint64_t> epoch{idleEpoch};
+    // false als de thread gestopt is, dan mag een nieuwe thread het record overnemen
+    atomic<bool> inUse{true};
+    // Enkel de eigen thread
+    unsigned depth = 0;
+};
+
+struct RetiredObject {
+    uint64_t epoch;
+    function<void()> deleter;
+};
+
+struct EpochState {
+    atomic<uint64_t> globalEpoch{0};
+    // Registratie van threads en het overlopen van de records door schrijvers
+    mutex recordsLock;
+    vector<unique_ptr<EpochRecord>> records;
+    mutex retiredLock;
+    vector<RetiredObject> retired;
+};
+
+static EpochState &state() {
+    // Nooit vrijgegeven, net als de trace-buffers: threads kunnen nog guards hebben tijdens het afsluiten
+    static EpochState *instance = new EpochState;
+    return *instance;
+}
+
+struct EpochRecordHolder {
+    EpochRecord *record = nullptr;
+
+    ~EpochRecordHolder() {
+        if (record) {
+            record->inUse.store(false, memory_order_release);
+        }
+    }
+};
+
+static thread_local EpochRecordHolder currentRecord;
+
+static EpochRecord &threadRecord() {
+    if (!currentRecord.record) {
+        EpochState &epochs = state();
+        lock_guard<mutex> guard(epochs.recordsLock);
+        for (const auto &record : epochs.records) {
+            if (!record->inUse.load(memory_order_acquire)) {
+                record->inUse.store(true, memory_order_relaxed);
+                currentRecord.record = record.get();
+                break;
+            }
+        }
+        if (!currentRecord.record) {
+            epochs.records.push_back(make_unique<EpochRecord>());
+            currentRecord.record = epochs.records.back().get();
+        }
+    }
+    return *currentRecord.record;
+}
+
+EpochGuard::EpochGuard() {
+    EpochRecord &record = threadRecord();
+    if (record.depth++ == 0) {
+        // seq_cst: de epoch moet zichtbaar zijn voor de lezer de pointer laadt, zie reclaimRetired()
+        record.epoch.store(state().globalEpoch.load(memory_order_seq_cst), memory_order_seq_cst);
+    }
+}
+
+EpochGuard::~EpochGuard() {
+    EpochRecord &record = *currentRecord.record;
+    if (--record.depth == 0) {
+        record.epoch.store(idleEpoch, memory_order_release);
+    }
+}
+
+// Kleinste epoch van een actieve lezer, idleEpoch als er geen is
+static uint64_t oldestReader(EpochState &epochs) {
+    lock_guard<mutex> guard(epochs.recordsLock);
+    uint64_t oldest = idleEpoch;
+    for (const auto &record : epochs.records) {
+        oldest = min(oldest, record->epoch.load(memory_order_seq_cst));
+    }
+    return oldest;
+}
+
+void retireObject(function<void()> deleter) {
+    EpochState &epochs = state();
+    {
+        lock_guard<mutex> guard(epochs.retiredLock);
+        // Het object is al vervangen; wie daarna binnenkomt krijgt een hogere epoch en ziet het niet meer
+        uint64_t epoch = epochs.globalEpoch.fetch_add(1, memory_order_seq_cst);
+        epochs.retired.push_back({epoch, move(deleter)});
+    }
+    reclaimRetired();
+}
+
+size_t reclaimRetired() {
+    EpochState &epochs = state();
+    vector<function<void()>> ready;
+    size_t waiting;
+    {
+        lock_guard<mutex> guard(epochs.retiredLock);
+        // Een lezer met epoch e kan enkel objecten zien die op epoch e of later vervangen zijn
+        uint64_t oldest = oldestReader(epochs);
+        size_t kept = 0;
+        for (auto &object : epochs.retired) {
+            if (object.epoch < oldest) {
+                ready.push_back(move(object.deleter));
+            } else {
+                epochs.retired[kept++] = move(object);
+            }
+        }
+        epochs.retired.resize(kept);
+        waiting = kept;
+    }
+    // Buiten de lock: het vrijgeven van een automaat kan even duren
+    for (auto &deleter : ready) {
+        deleter();
+    }
+    return waiting;
+}
+
+void synchronizeEpochs() {
+    EpochState &epochs = state();
+    uint64_t target = epochs.globalEpoch.fetch_add(1, memory_order_seq_cst);
+    while (true) {
+        reclaimRetired();
+        bool pending = false;
+        {
+            lock_guard<mutex> guard(epochs.retiredLock);
+            for (const auto &object : epochs.retired) {
+                pending = pending || object.epoch <= target;
+            }
+        }
+        if (!pending) {
+            return;
+        }
+        this_thread::sleep_for(chrono::microseconds(50));
+    }
+}
@@ -0,0 +1,97 @@
+//
+// Epoch-based reclamation and RCU-style publication of immutable objects.
+//
+
+#ifndef TABLEFILLINGALGORITHM_EPOCHRECLAMATION_H
+#define TABLEFILLINGALGORITHM_EPOCHRECLAMATION_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+using namespace std;
+
+
+// A reader holds an EpochGuard while it uses objects it loaded from a SnapshotPointer. Entering
+// and leaving are two atomic stores on a record of the calling thread, without locks; only the
+// first guard of a thread registers its record (a record of a finished thread is reused). Guards
+// may be nested. Do not block or wait for a writer while holding one: that delays reclamation,
+// although it never blocks the writer itself.
+class EpochGuard {
+public:
+    EpochGuard();
+    ~EpochGuard();
+
+    EpochGuard(const EpochGuard &) = delete;
+    EpochGuard &operator=(const EpochGuard &) = delete;
+};
+
+// Runs deleter once no reader can still see the object: after every guard that was active when
+// the object was retired has ended. Writers only; the deleters run on a thread that retires or
+// calls reclaimRetired().
+void retireObject(function<void()> deleter);
+// Runs the deleters that are safe now, returns how many are still waiting
+size_t reclaimRetired();
+// Waits until everything retired before the call is freed. Must not be called inside a guard.
+void synchronizeEpochs();
+
+// Atomic pointer to an immutable T, replaced as a whole: readers load() inside an EpochGuard and
+// never lock, writers publish() a new version and the old one is deleted once its readers are
+// gone. Writers are serialized among themselves.
+//
+//     EpochGuard guard;
+//     const T *current = pointer.load();   // valid until the guard ends
+template <class T>
+class SnapshotPointer {
+private:
+    atomic<const T *> current;
+    mutex writerMutex;
+
+    // Onder writerMutex
+    void replace(unique_ptr<const T> next) {
+        const T *previous = current.exchange(next.release(), memory_order_seq_cst);
+        if (previous) {
+            retireObject([previous]() { delete previous; });
+        }
+    }
+
+public:
+    explicit SnapshotPointer(unique_ptr<const T> initial = nullptr) : current(initial.release()) {}
+
+    // No reader may be left
+    ~SnapshotPointer() {
+        delete current.load();
+    }
+
+    SnapshotPointer(const SnapshotPointer &) = delete;
+    SnapshotPointer &operator=(const SnapshotPointer &) = delete;
+
+    // Only inside an EpochGuard; nullptr before the first publish()
+    const T *load() const {
+        return current.load(memory_order_seq_cst);
+    }
+
+    void publish(unique_ptr<const T> next) {
+        lock_guard<mutex> lock(writerMutex);
+        replace(move(next));
+    }
+
+    // Read-copy-update: change gets the current version (nullptr if there is none) and returns the
+    // next one, or nullptr to keep the current one. No other writer runs in between. Returns
+    // whether a new version was published.
+    template <class Change>
+    bool update(Change change) {
+        lock_guard<mutex> lock(writerMutex);
+        unique_ptr<const T> next = change(current.load(memory_order_acquire));
+        if (!next) {
+            return false;
+        }
+        replace(move(next));
+        return true;
+    }
+};
+
+
+#endif //TABLEFILLINGALGORITHM_EPOCHRECLAMATION_H
@@ -0,0 +1,141 @@
+//
+// 128-bit hashes used for language fingerprints and content addressing.
+//
+
+#include "Fingerprint.h"
+#include <cstring>
+using namespace std;
+
+static inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t fmix64(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xFF51AFD7ED558CCDULL;
+    k ^= k >> 33;
+    k *= 0xC4CEB9FE1A85EC53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+static inline uint64_t readLittleEndian64(const unsigned char *bytes) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+Fingerprint hash128(const void *data, size_t length, uint64_t seed) {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    const size_t blockCount = length / 16;
+    const uint64_t c1 = 0x87C37B91114253D5ULL;
+    const uint64_t c2 = 0x4CF5AD432745937FULL;
+
+    uint64_t h1 = seed;
+    uint64_t h2 = seed;
+
+    // Blokken van 16 bytes
+    for (size_t i = 0; i < blockCount; ++i) {
+        uint64_t k1 = readLittleEndian64(bytes + i * 16);
+        uint64_t k2 = readLittleEndian64(bytes + i * 16 + 8);
+
+        k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+        h1 = rotl64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52DCE729;
+
+        k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+        h2 = rotl64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495AB5;
+    }
+
+    // Staart
+    const unsigned char *tail = bytes + blockCount * 16;
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+    switch (length & 15) {
+        case 15: k2 ^= uint64_t(tail[14]) << 48; // fallthrough
+        case 14: k2 ^= uint64_t(tail[13]) << 40; // fallthrough
+        case 13: k2 ^= uint64_t(tail[12]) << 32; // fallthrough
+        case 12: k2 ^= uint64_t(tail[11]) << 24; // fallthrough
+        case 11: k2 ^= uint64_t(tail[10]) << 16; // fallthrough
+        case 10: k2 ^= uint64_t(tail[9]) << 8;   // fallthrough
+        case 9:  k2 ^= uint64_t(tail[8]);
+                 k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+                 // fallthrough
+        case 8:  k1 ^= uint64_t(tail[7]) << 56; // fallthrough
+        case 7:  k1 ^= uint64_t(tail[6]) << 48; // fallthrough
+        case 6:  k1 ^= uint64_t(tail[5]) << 40; // fallthrough
+        case 5:  k1 ^= uint64_t(tail[4]) << 32; // fallthrough
+        case 4:  k1 ^= uint64_t(tail[3]) << 24; // fallthrough
+        case 3:  k1 ^= uint64_t(tail[2]) << 16; // fallthrough
+        case 2:  k1 ^= uint64_t(tail[1]) << 8;  // fallthrough
+        case 1:  k1 ^= uint64_t(tail[0]);
+                 k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+        default: break;
+    }
+
+    // Finalisatie
+    h1 ^= length;
+    h2 ^= length;
+    h1 += h2;
+    h2 += h1;
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+    h1 += h2;
+    h2 += h1;
+
+    Fingerprint fingerprint;
+    fingerprint.high = h2;
+    fingerprint.low = h1;
+    return fingerprint;
+}
+
+Fingerprint hash128(const string &data, uint64_t seed) {
+    return hash128(data.data(), data.size(), seed);
+}
+
+string Fingerprint::toHex() const {
+    static const char digits[] = "0123456789abcdef";
+    string hex(32, '0');
+    for (int i = 0; i < 16; ++i) {
+        hex[15 - i] = digits[(high >> (4 * i)) & 0xF];
+        hex[31 - i] = digits[(low >> (4 * i)) & 0xF];
+    }
+    return hex;
+}
+
+bool Fingerprint::fromHex(const string &hex, Fingerprint &fingerprint) {
+    if (hex.size() != 32) {
+        return false;
+    }
+    uint64_t words[2] = {0, 0};
+    for (int i = 0; i < 32; ++i) {
+        char c = hex[i];
+        uint64_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            digit = c - 'A' + 10;
+        } else {
+            return false;
+        }
+        words[i / 16] = (words[i / 16] << 4) | digit;
+    }
+    fingerprint.high = words[0];
+    fingerprint.low = words[1];
+    return true;
+}
+
+bool operator==(const Fingerprint &lhs, const Fingerprint &rhs) {
+    return lhs.high == rhs.high && lhs.low == rhs.low;
+}
+
+bool operator!=(const Fingerprint &lhs, const Fingerprint &rhs) {
+    return !(lhs == rhs);
+}
+
+bool operator<(const Fingerprint &lhs, const Fingerprint &rhs) {
+    return lhs.high != rhs.high ? lhs.high < rhs.high : lhs.low < rhs.low;
+}
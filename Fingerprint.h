@@ -0,0 +1,43 @@
+//
+// 128-bit hashes used for language fingerprints and content addressing.
+//
+
+#ifndef TABLEFILLINGALGORITHM_FINGERPRINT_H
+#define TABLEFILLINGALGORITHM_FINGERPRINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+using namespace std;
+
+
+struct Fingerprint {
+    uint64_t high = 0;
+    uint64_t low = 0;
+
+    // 32 hexadecimal digits, high word first
+    string toHex() const;
+    static bool fromHex(const string &hex, Fingerprint &fingerprint);
+};
+
+bool operator==(const Fingerprint &lhs, const Fingerprint &rhs);
+bool operator!=(const Fingerprint &lhs, const Fingerprint &rhs);
+bool operator<(const Fingerprint &lhs, const Fingerprint &rhs);
+
+// MurmurHash3 x64 128-bit
+Fingerprint hash128(const void *data, size_t length, uint64_t seed = 0);
+Fingerprint hash128(const string &data, uint64_t seed = 0);
+
+namespace std {
+    template <>
+    struct hash<Fingerprint> {
+        size_t operator()(const Fingerprint &fingerprint) const {
+            return fingerprint.low ^ (fingerprint.high * 0x9E3779B97F4A7C15ULL);
+        }
+    };
+}
+
+
+#endif //TABLEFILLINGALGORITHM_FINGERPRINT_H
@@ -0,0 +1,84 @@
+//
+// Command line front end of DFAGenerators: writes a synthetic DFA as JSON or in the binary format.
+//
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "BinaryDFA.h"
+#include "DFAGenerators.h"
+#include "JsonWriter.h"
+using namespace std;
+
+static int usage() {
+    cerr << "usage: TableFillingGenerate [--family name] [--symbols k] [--seed n] [--tolerance t | --exact]\n"
+            "                            [--binary] <states> <output file>\n"
+            "families:";
+    for (const auto &family : dfaFamilies()) {
+        cerr << " " << family;
+    }
+    cerr << "\n--symbols and --tolerance only apply to the uniform and random families; the default\n"
+            "tolerance of the uniform family is states / 1000" << endl;
+    return 2;
+}
+
+int main(int argc, char **argv) {
+    string family = "uniform";
+    uint32_t symbols = 2;
+    uint64_t seed = 1;
+    long long tolerance = -1;
+    bool binary = false;
+    vector<string> arguments;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            bool hasValue = i + 1 < argc;
+            if (strcmp(argv[i], "--family") == 0 && hasValue) {
+                family = argv[++i];
+            } else if (strcmp(argv[i], "--symbols") == 0 && hasValue) {
+                symbols = stoul(argv[++i]);
+            } else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+                seed = stoull(argv[++i]);
+            } else if (strcmp(argv[i], "--tolerance") == 0 && hasValue) {
+                tolerance = stoll(argv[++i]);
+            } else if (strcmp(argv[i], "--exact") == 0) {
+                tolerance = 0;
+            } else if (strcmp(argv[i], "--binary") == 0) {
+                binary = true;
+            } else {
+                arguments.push_back(argv[i]);
+            }
+        }
+    } catch (const exception &) {
+        return usage();
+    }
+    if (arguments.size() != 2) {
+        return usage();
+    }
+
+    try {
+        uint32_t stateCount = stoul(arguments[0]);
+        CompiledDFA dfa;
+        if (family == "uniform") {
+            dfa = uniformAccessibleDFA(stateCount, symbols, seed, tolerance < 0 ? stateCount / 1000 : tolerance);
+        } else if (family == "random") {
+            dfa = randomCompleteDFA(stateCount, symbols, seed);
+        } else {
+            dfa = generateFamily(family, stateCount, seed);
+        }
+
+        if (binary) {
+            writeBinaryDFA(dfa, arguments[1]);
+        } else {
+            ofstream output(arguments[1]);
+            writeDFAJson(dfa, output, true);
+            if (!output) {
+                throw runtime_error("cannot write " + arguments[1]);
+            }
+        }
+        cerr << dfa.getStateCount() << " states" << endl;
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
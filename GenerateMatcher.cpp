@@ -0,0 +1,57 @@
+//
+// Command line front end of MatcherGenerator: DFA file in, matcher header out.
+//
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "BinaryDFA.h"
+#include "MatcherGenerator.h"
+using namespace std;
+
+static int usage() {
+    cerr << "usage: TableFillingCodegen [--table] [--no-minimize] <dfa file> <function> <output.h>" << endl;
+    return 2;
+}
+
+int main(int argc, char **argv) {
+    MatcherStyle style = MatcherStyle::Switch;
+    bool minimize = true;
+    vector<string> arguments;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--table") == 0) {
+            style = MatcherStyle::Table;
+        } else if (strcmp(argv[i], "--no-minimize") == 0) {
+            minimize = false;
+        } else {
+            arguments.push_back(argv[i]);
+        }
+    }
+    if (arguments.size() != 3) {
+        return usage();
+    }
+
+    try {
+        CompiledDFA dfa = readDFAFile(arguments[0]);
+        if (minimize) {
+            dfa = dfa.minimize();
+        }
+
+        // Eerst naar een tijdelijk bestand, zodat een afgebroken build geen half bestand achterlaat
+        string temporary = arguments[2] + ".tmp";
+        {
+            ofstream output(temporary);
+            writeMatcherHeader(dfa, arguments[1], style, output);
+            if (!output) {
+                throw runtime_error("cannot write " + temporary);
+            }
+        }
+        if (rename(temporary.c_str(), arguments[2].c_str()) != 0) {
+            throw runtime_error("cannot write " + arguments[2]);
+        }
+    } catch (const exception &e) {
+        cerr << arguments[0] << ": " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
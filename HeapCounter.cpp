@@ -0,0 +1,63 @@
+//
+// Live and peak bytes of the global operator new, for the whole process.
+//
+
+#include "HeapCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+using namespace std;
+
+static atomic<size_t> current{0};
+static atomic<size_t> peak{0};
+
+static void *counted(void *pointer) {
+    if (pointer == nullptr) {
+        throw bad_alloc();
+    }
+    size_t bytes = malloc_usable_size(pointer);
+    size_t now = current.fetch_add(bytes, memory_order_relaxed) + bytes;
+    size_t highest = peak.load(memory_order_relaxed);
+    while (now > highest && !peak.compare_exchange_weak(highest, now, memory_order_relaxed)) {
+    }
+    return pointer;
+}
+
+static void release(void *pointer) {
+    if (pointer != nullptr) {
+        current.fetch_sub(malloc_usable_size(pointer), memory_order_relaxed);
+        free(pointer);
+    }
+}
+
+size_t getHeapCurrent() {
+    return current.load(memory_order_relaxed);
+}
+
+size_t getHeapPeak() {
+    return peak.load(memory_order_relaxed);
+}
+
+void resetHeapPeak() {
+    peak.store(current.load(memory_order_relaxed), memory_order_relaxed);
+}
+
+// De nothrow-, array- en sized-varianten roepen standaard deze vier op
+void *operator new(size_t bytes) {
+    return counted(malloc(bytes == 0 ? 1 : bytes));
+}
+
+void *operator new(size_t bytes, align_val_t alignment) {
+    // aligned_alloc wil een veelvoud van de alignering
+    size_t align = size_t(alignment);
+    return counted(aligned_alloc(align, (bytes + align - 1) / align * align + (bytes == 0 ? align : 0)));
+}
+
+void operator delete(void *pointer) noexcept {
+    release(pointer);
+}
+
+void operator delete(void *pointer, align_val_t) noexcept {
+    release(pointer);
+}
@@ -0,0 +1,24 @@
+//
+// Live and peak bytes of the global operator new, for the whole process.
+//
+
+#ifndef TABLEFILLINGALGORITHM_HEAPCOUNTER_H
+#define TABLEFILLINGALGORITHM_HEAPCOUNTER_H
+
+#include <cstddef>
+
+using namespace std;
+
+
+// HeapCounter.cpp replaces the global operator new and delete, so every allocation of the
+// program is counted: containers, copies and strings as well as the pmr scratch buffers that
+// PeakMemoryResource sees. Sizes are what malloc_usable_size() reports, the bytes the allocator
+// really reserved. Only the benchmark links it; every allocation costs a few atomic operations.
+// Counts of all threads together.
+size_t getHeapCurrent();
+size_t getHeapPeak();
+// Peak back to the current value
+void resetHeapPeak();
+
+
+#endif //TABLEFILLINGALGORITHM_HEAPCOUNTER_H
@@ -0,0 +1,239 @@
+//
+// Runtime compilation of a DFA into x86-64 machine code.
+//
+
+#include "JitMatcher.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "Trace.h"
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define TFA_JIT_X86_64
+#endif
+using namespace std;
+
+#ifdef TFA_JIT_X86_64
+
+// Net genoeg x86-64 voor de matcher. Sprongen en sprongtabellen verwijzen naar labels die pas
+// in finish() ingevuld worden, zodat voorwaartse sprongen geen tweede pass nodig hebben.
+class Assembler {
+private:
+    vector<unsigned char> bytes;
+    vector<int64_t> labels;
+    // Positie van een rel32 en het label waarnaar het springt (relatief t.o.v. het einde van het veld)
+    vector<pair<size_t, uint32_t>> relativeJumps;
+    struct TableEntry {
+        size_t position;
+        uint32_t table;
+        uint32_t label;
+    };
+    vector<TableEntry> tableEntries;
+
+    void emit32(uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            bytes.push_back((value >> (8 * i)) & 0xFF);
+        }
+    }
+
+    void relative(uint32_t label) {
+        relativeJumps.emplace_back(bytes.size(), label);
+        emit32(0);
+    }
+
+public:
+    explicit Assembler(size_t labelCount) : labels(labelCount, -1) {}
+
+    void emit(initializer_list<unsigned char> code) {
+        bytes.insert(bytes.end(), code);
+    }
+
+    void place(uint32_t label) {
+        labels[label] = bytes.size();
+    }
+
+    void align(size_t alignment) {
+        while (bytes.size() % alignment != 0) {
+            bytes.push_back(0xCC);  // int3
+        }
+    }
+
+    void jmp(uint32_t label) {
+        emit({0xE9});
+        relative(label);
+    }
+
+    void je(uint32_t label) {
+        emit({0x0F, 0x84});
+        relative(label);
+    }
+
+    // cmp al, imm8; je label
+    void jumpIfByte(unsigned char value, uint32_t label) {
+        emit({0x3C, value});
+        je(label);
+    }
+
+    // lea rcx, [rip + table]; movsxd rax, dword [rcx + rax * 4]; add rax, rcx; jmp rax
+    void jumpThroughTable(uint32_t table) {
+        emit({0x48, 0x8D, 0x0D});
+        relative(table);
+        emit({0x48, 0x63, 0x04, 0x81, 0x48, 0x01, 0xC8, 0xFF, 0xE0});
+    }
+
+    // int32 afstand van het begin van table tot label
+    void tableEntry(uint32_t table, uint32_t label) {
+        tableEntries.push_back({bytes.size(), table, label});
+        emit32(0);
+    }
+
+    vector<unsigned char> finish() {
+        auto patch = [&](size_t position, int64_t value) {
+            for (int i = 0; i < 4; ++i) {
+                bytes[position + i] = (uint64_t(value) >> (8 * i)) & 0xFF;
+            }
+        };
+        for (const auto &jump : relativeJumps) {
+            patch(jump.first, labels[jump.second] - int64_t(jump.first + 4));
+        }
+        for (const auto &entry : tableEntries) {
+            patch(entry.position, labels[entry.label] - labels[entry.table]);
+        }
+        return move(bytes);
+    }
+};
+
+// Vanaf zoveel uitgaande transities is één sprongtabel goedkoper dan een rij vergelijkingen
+static const size_t jumpTableThreshold = 8;
+
+// bool match(const unsigned char *input /* rdi */, const unsigned char *end /* rsi */)
+static vector<unsigned char> assemble(const CompiledDFA &dfa) {
+    uint32_t stateCount = dfa.getStateCount();
+    uint32_t acceptLabel = stateCount, rejectLabel = stateCount + 1;
+    vector<uint32_t> tableStates;
+    // Labels: staten, accept, reject en daarna één per sprongtabel (hoogstens één per staat)
+    Assembler assembler(2 * size_t(stateCount) + 2);
+
+    auto targetLabel = [&](uint32_t state, int byte) {
+        uint32_t to = dfa.getTransitionOn(state, char(byte));
+        return to == CompiledDFA::deadState ? rejectLabel : to;
+    };
+
+    if (dfa.getStartState() == CompiledDFA::deadState) {
+        assembler.jmp(rejectLabel);
+    } else {
+        assembler.jmp(dfa.getStartState());
+        for (uint32_t state = 0; state < stateCount; ++state) {
+            assembler.place(state);
+            // cmp rdi, rsi; je accept/reject
+            assembler.emit({0x48, 0x39, 0xF7});
+            assembler.je(dfa.isAccepting(state) ? acceptLabel : rejectLabel);
+            // movzx eax, byte [rdi]; inc rdi
+            assembler.emit({0x0F, 0xB6, 0x07, 0x48, 0xFF, 0xC7});
+
+            size_t outgoing = 0;
+            for (int byte = 0; byte < 256; ++byte) {
+                outgoing += targetLabel(state, byte) != rejectLabel;
+            }
+            if (outgoing < jumpTableThreshold) {
+                for (int byte = 0; byte < 256; ++byte) {
+                    uint32_t label = targetLabel(state, byte);
+                    if (label != rejectLabel) {
+                        assembler.jumpIfByte(byte, label);
+                    }
+                }
+                assembler.jmp(rejectLabel);
+            } else {
+                assembler.jumpThroughTable(stateCount + 2 + tableStates.size());
+                tableStates.push_back(state);
+            }
+        }
+    }
+
+    // mov eax, 1; ret
+    assembler.place(acceptLabel);
+    assembler.emit({0xB8, 0x01, 0x00, 0x00, 0x00, 0xC3});
+    // xor eax, eax; ret
+    assembler.place(rejectLabel);
+    assembler.emit({0x31, 0xC0, 0xC3});
+
+    assembler.align(4);
+    for (size_t i = 0; i < tableStates.size(); ++i) {
+        uint32_t table = stateCount + 2 + i;
+        assembler.place(table);
+        for (int byte = 0; byte < 256; ++byte) {
+            assembler.tableEntry(table, targetLabel(tableStates[i], byte));
+        }
+    }
+    return assembler.finish();
+}
+
+JitMatcher::JitMatcher(const CompiledDFA &dfa) {
+    TraceSpan span("jit");
+    vector<unsigned char> machineCode = assemble(dfa);
+
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+    codeSize = (machineCode.size() + pageSize - 1) / pageSize * pageSize;
+    void *mapping = mmap(nullptr, codeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+        throw runtime_error(string("cannot map JIT code: ") + strerror(errno));
+    }
+    memcpy(mapping, machineCode.data(), machineCode.size());
+    // Nooit schrijfbaar en uitvoerbaar tegelijk
+    if (mprotect(mapping, codeSize, PROT_READ | PROT_EXEC) != 0) {
+        int error = errno;
+        munmap(mapping, codeSize);
+        throw runtime_error(string("cannot make JIT code executable: ") + strerror(error));
+    }
+    code = mapping;
+    codeSize = machineCode.size();
+    function = reinterpret_cast<MatchFunction>(code);
+}
+
+JitMatcher::~JitMatcher() {
+    if (code != nullptr) {
+        size_t pageSize = sysconf(_SC_PAGESIZE);
+        munmap(code, (codeSize + pageSize - 1) / pageSize * pageSize);
+    }
+}
+
+bool JitMatcher::isSupported() {
+    return true;
+}
+
+#else
+
+JitMatcher::JitMatcher(const CompiledDFA &) {
+    throw runtime_error("JIT compilation needs Linux on x86-64");
+}
+
+JitMatcher::~JitMatcher() {}
+
+bool JitMatcher::isSupported() {
+    return false;
+}
+
+#endif
+
+JitMatcher::JitMatcher(JitMatcher &&other) noexcept
+        : code(exchange(other.code, nullptr)), codeSize(exchange(other.codeSize, 0)),
+          function(exchange(other.function, nullptr)) {}
+
+JitMatcher &JitMatcher::operator=(JitMatcher &&other) noexcept {
+    swap(code, other.code);
+    swap(codeSize, other.codeSize);
+    swap(function, other.function);
+    return *this;
+}
+
+bool JitMatcher::accepts(string_view input) const {
+    auto begin = reinterpret_cast<const unsigned char *>(input.data());
+    return function(begin, begin + input.size());
+}
+
+size_t JitMatcher::getCodeSize() const {
+    return codeSize;
+}
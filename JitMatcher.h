@@ -0,0 +1,53 @@
+//
+// Runtime compilation of a DFA into x86-64 machine code.
+//
+
+#ifndef TABLEFILLINGALGORITHM_JITMATCHER_H
+#define TABLEFILLINGALGORITHM_JITMATCHER_H
+
+#include <cstddef>
+#include <string_view>
+#include "CompiledDFA.h"
+
+using namespace std;
+
+
+// Every state becomes a block of machine code: at the end of the input it returns whether the
+// state accepts, otherwise it reads the next byte and jumps to the block of the next state. Few
+// outgoing transitions give a chain of compares, many give a 256-entry jump table. Missing
+// transitions and bytes outside the alphabet return false, exactly like CompiledDFA::accepts().
+// It wins when the branches are predictable (small automata, long runs through the same states);
+// on random input over states with many transitions every dispatch mispredicts and the table
+// walk is faster.
+//
+// The code is written into an anonymous mapping that is made executable (and no longer writable)
+// before use. Only Linux on x86-64 is supported; elsewhere the constructor throws runtime_error,
+// use DFAMatcher to fall back to the table walk automatically.
+class JitMatcher {
+private:
+    typedef bool (*MatchFunction)(const unsigned char *input, const unsigned char *end);
+
+    void *code = nullptr;
+    size_t codeSize = 0;
+    MatchFunction function = nullptr;
+
+public:
+    explicit JitMatcher(const CompiledDFA &dfa);
+    ~JitMatcher();
+
+    JitMatcher(const JitMatcher &) = delete;
+    JitMatcher &operator=(const JitMatcher &) = delete;
+    JitMatcher(JitMatcher &&other) noexcept;
+    JitMatcher &operator=(JitMatcher &&other) noexcept;
+
+    bool accepts(string_view input) const;
+
+    // Bytes of machine code and jump tables
+    size_t getCodeSize() const;
+
+    // false on platforms where the constructor always throws
+    static bool isSupported();
+};
+
+
+#endif //TABLEFILLINGALGORITHM_JITMATCHER_H
@@ -0,0 +1,186 @@
+//
+// Runs jobs given as one JSON object per line: minimize, equivalence, accepts and fingerprint.
+//
+
+#include "JobRunner.h"
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include "json.hpp"
+#include "BinaryDFA.h"
+#include "DFAMatcher.h"
+#include "JsonLoader.h"
+#include "JsonWriter.h"
+#include "Trace.h"
+using namespace std;
+
+using json = nlohmann::json;
+
+JobRunner::JobRunner() : resolver(loadFile) {}
+
+JobRunner::JobRunner(Resolver resolver) : resolver(move(resolver)) {}
+
+shared_ptr<const CompiledDFA> JobRunner::loadFile(const string &path) {
+    return make_shared<const CompiledDFA>(readDFAFile(path));
+}
+
+// Pad of naam via de resolver, of een DFA in het invoerformaat
+static shared_ptr<const CompiledDFA> resolveDFA(const json &job, const string &key,
+                                                const JobRunner::Resolver &resolver) {
+    auto value = job.find(key);
+    if (value == job.end()) {
+        throw runtime_error("missing \"" + key + "\"");
+    }
+    if (value->is_string()) {
+        shared_ptr<const CompiledDFA> dfa = resolver(value->get<string>());
+        if (!dfa) {
+            throw runtime_error("unknown DFA " + value->get<string>());
+        }
+        return dfa;
+    }
+    if (value->is_object()) {
+        return make_shared<const CompiledDFA>(parseCompiledDFA(value->dump()));
+    }
+    throw runtime_error("\"" + key + "\" must be a path or a DFA object");
+}
+
+static string stringOption(const json &job, const string &key, const string &fallback) {
+    auto value = job.find(key);
+    return value == job.end() ? fallback : value->get<string>();
+}
+
+// Vult result aan; minimalJson krijgt de minimale automaat als JSON als er geen output is
+static void runMinimize(const json &job, const JobRunner::Resolver &resolver, json &result, string &minimalJson) {
+    shared_ptr<const CompiledDFA> dfa = resolveDFA(job, "dfa", resolver);
+    string algorithm = stringOption(job, "algorithm", "hopcroft");
+    CompiledDFA minimal;
+    if (algorithm == "hopcroft") {
+        minimal = dfa->minimize();
+    } else if (algorithm == "table") {
+        // Table filling op de stringvoorstelling, met de MinimizationCache. Die houdt de put van
+        // een volledige DFA; trimmen zodat beide algoritmen dezelfde (partiële) automaat geven
+        minimal = CompiledDFA(dfa->toDFA().minimize()).trim();
+    } else {
+        throw runtime_error("unknown algorithm " + algorithm);
+    }
+    result["states"] = minimal.getStateCount();
+
+    auto output = job.find("output");
+    if (output == job.end()) {
+        ostringstream document;
+        writeDFAJson(minimal, document, true);
+        minimalJson = document.str();
+    } else if (job.value("binary", false)) {
+        writeBinaryDFA(minimal, output->get<string>());
+    } else {
+        ofstream file(output->get<string>());
+        writeDFAJson(minimal, file, true);
+        if (!file) {
+            throw runtime_error("cannot write " + output->get<string>());
+        }
+    }
+}
+
+// Symbolen zijn bytes, een getuige hoeft geen geldige UTF-8 te zijn
+static void setWitness(json &result, const string &witness, const char *acceptedBy) {
+    static const char digits[] = "0123456789abcdef";
+    string hex;
+    for (unsigned char c : witness) {
+        hex += digits[c >> 4];
+        hex += digits[c & 15];
+    }
+    result["equivalent"] = false;
+    result["witness"] = witness;
+    result["witnessHex"] = hex;
+    result["acceptedBy"] = acceptedBy;
+}
+
+static void runEquivalence(const json &job, const JobRunner::Resolver &resolver, json &result) {
+    shared_ptr<const CompiledDFA> dfa = resolveDFA(job, "dfa", resolver);
+    shared_ptr<const CompiledDFA> other = resolveDFA(job, "other", resolver);
+    string witness;
+    if (!dfa->isSubsetOf(*other, witness)) {
+        setWitness(result, witness, "dfa");
+    } else if (!other->isSubsetOf(*dfa, witness)) {
+        setWitness(result, witness, "other");
+    } else {
+        result["equivalent"] = true;
+    }
+}
+
+static void runAccepts(const json &job, const JobRunner::Resolver &resolver, json &result) {
+    shared_ptr<const CompiledDFA> dfa = resolveDFA(job, "dfa", resolver);
+    auto inputs = job.find("inputs");
+    if (inputs == job.end() || !inputs->is_array()) {
+        throw runtime_error("\"inputs\" must be an array of strings");
+    }
+    string engine = stringOption(job, "engine", "table");
+    vector<bool> results;
+    results.reserve(inputs->size());
+    if (engine == "table") {
+        for (const auto &input : *inputs) {
+            results.push_back(dfa->accepts(input.get_ref<const string &>()));
+        }
+    } else if (engine == "jit") {
+        // De code compileren loont pas bij veel of lange invoer, dat beslist de aanvrager
+        DFAMatcher matcher(*dfa, MatchEngine::Jit);
+        for (const auto &input : *inputs) {
+            results.push_back(matcher.accepts(input.get_ref<const string &>()));
+        }
+    } else {
+        throw runtime_error("unknown engine " + engine);
+    }
+    result["results"] = results;
+}
+
+string JobRunner::run(const string &line) const {
+    TraceSpan span("job");
+    auto start = chrono::steady_clock::now();
+    json result = json::object();
+    result["id"] = nullptr;
+    string minimalJson;
+    try {
+        json job = json::parse(line);
+        if (!job.is_object()) {
+            throw runtime_error("a job must be a JSON object");
+        }
+        if (job.contains("id")) {
+            result["id"] = job["id"];
+        }
+        string op = stringOption(job, "op", "");
+        result["op"] = op;
+        if (op == "minimize") {
+            runMinimize(job, resolver, result, minimalJson);
+        } else if (op == "equivalence") {
+            runEquivalence(job, resolver, result);
+        } else if (op == "accepts") {
+            runAccepts(job, resolver, result);
+        } else if (op == "fingerprint") {
+            result["fingerprint"] = resolveDFA(job, "dfa", resolver)->fingerprint().toHex();
+        } else {
+            throw runtime_error(op.empty() ? "missing \"op\"" : "unknown op " + op);
+        }
+        result["ok"] = true;
+    } catch (const exception &e) {
+        result["ok"] = false;
+        result["error"] = e.what();
+        minimalJson.clear();
+    }
+    result["micros"] = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+
+    // Foutmeldingen en getuigen kunnen ruwe bytes bevatten: ongeldige UTF-8 wordt U+FFFD
+    string output;
+    try {
+        output = result.dump(-1, ' ', false, json::error_handler_t::replace);
+    } catch (const exception &e) {
+        minimalJson.clear();
+        json failed = {{"id", result["id"]}, {"ok", false}, {"error", e.what()}};
+        output = failed.dump(-1, ' ', false, json::error_handler_t::replace);
+    }
+    if (!minimalJson.empty()) {
+        // De automaat is al JSON, niet nog eens via een DOM
+        output.pop_back();
+        output += ",\"dfa\":" + minimalJson + "}";
+    }
+    return output;
+}
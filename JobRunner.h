@@ -0,0 +1,57 @@
+//
+// Runs jobs given as one JSON object per line: minimize, equivalence, accepts and fingerprint.
+//
+
+#ifndef TABLEFILLINGALGORITHM_JOBRUNNER_H
+#define TABLEFILLINGALGORITHM_JOBRUNNER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include "CompiledDFA.h"
+
+using namespace std;
+
+
+// A job is a JSON object with an "op" and the automata it works on; "id" (any JSON value) is
+// copied into the result so results can be matched to jobs when they finish out of order.
+// An automaton ("dfa", and "other" for equivalence) is either a string, resolved through the
+// Resolver (a file path by default, JSON or binary format), or an inline object in the input
+// format of DFA.
+//
+//   {"op": "minimize", "dfa": ..., "algorithm": "hopcroft" | "table", "output": path, "binary": bool}
+//       -> "states" and the minimal automaton as "dfa", or written to output instead. The minimal
+//          automaton is trimmed and therefore partial: no sink state, missing transitions reject.
+//          Both algorithms give the same automaton up to state names.
+//   {"op": "equivalence", "dfa": ..., "other": ...}
+//       -> "equivalent", and when false a shortest "witness" (also as "witnessHex", the bytes in hex,
+//          because invalid UTF-8 in "witness" is replaced) and the side ("dfa" | "other") that accepts it
+//   {"op": "accepts", "dfa": ..., "inputs": [...], "engine": "table" | "jit"}
+//       -> "results", one bool per input
+//   {"op": "fingerprint", "dfa": ...}
+//       -> "fingerprint" as 32 hex digits
+//
+// Every result has "id", "op", "ok" and "micros"; when ok is false "error" says why.
+class JobRunner {
+public:
+    typedef function<shared_ptr<const CompiledDFA>(const string &)> Resolver;
+
+private:
+    Resolver resolver;
+
+public:
+    // Strings are file paths
+    JobRunner();
+    explicit JobRunner(Resolver resolver);
+
+    // One job line in, one result line out (without newline). Never throws: malformed JSON,
+    // unknown ops and failing jobs give a result with ok false. Safe to call from several threads
+    // as long as the resolver is.
+    string run(const string &line) const;
+
+    // The default resolver: readDFAFile()
+    static shared_ptr<const CompiledDFA> loadFile(const string &path);
+};
+
+
+#endif //TABLEFILLINGALGORITHM_JOBRUNNER_H
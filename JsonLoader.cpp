@@ -0,0 +1,212 @@
+//
+// Streaming (SAX) loader from the JSON input format straight into a CompiledDFA.
+//
+
+#include "JsonLoader.h"
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include "json.hpp"
+#include "MinimizationStats.h"
+#include "Trace.h"
+using namespace std;
+
+using json = nlohmann::json;
+
+// Event handler for json::sax_parse (the interface has a member called string, hence std::string
+// inside the class). Only the values that matter are looked at:
+//   depth 1: keys of the top level object
+//   depth 2: letters of "alphabet"
+//   depth 3: fields of a state or transition object
+class DFASaxHandler {
+private:
+    enum Section { None, Alphabet, States, Transitions };
+
+    CompiledDFA &dfa;
+    // Naam-id in de pool van dfa -> staat, deadState voor namen die nog geen staat zijn
+    vector<uint32_t> stateOfNameId;
+
+    int depth = 0;
+    Section section = None;
+    std::string currentKey;
+
+    // Velden van het huidige state- of transitie-object, hergebruikt voor elk element
+    std::string name, from, to, input;
+    bool hasName = false, hasFrom = false, hasTo = false, hasInput = false;
+    bool starting = false, accepting = false;
+
+    uint32_t intern(const std::string &state) {
+        uint32_t id = dfa.getStringPool()->intern(state);
+        if (id >= stateOfNameId.size()) {
+            stateOfNameId.resize(id + 1, CompiledDFA::deadState);
+        }
+        if (stateOfNameId[id] == CompiledDFA::deadState) {
+            stateOfNameId[id] = dfa.addStateWithNameId(id);
+        }
+        return stateOfNameId[id];
+    }
+
+    bool inElement() const {
+        return depth == 3 && (section == States || section == Transitions);
+    }
+
+    void finishState() {
+        if (!hasName) {
+            throw runtime_error("state without \"name\"");
+        }
+        uint32_t state = intern(name);
+        if (accepting) {
+            dfa.setAccepting(state, true);
+        }
+        if (starting) {
+            dfa.setStartState(state);
+        }
+    }
+
+    void finishTransition() {
+        if (!hasFrom || !hasTo || !hasInput) {
+            throw runtime_error("transition needs \"from\", \"to\" and \"input\"");
+        }
+        int symbol = dfa.addSymbol(input[0]);
+        uint32_t fromState = intern(from);
+        uint32_t toState = intern(to);
+        dfa.setTransition(fromState, symbol, toState);
+    }
+
+public:
+    explicit DFASaxHandler(CompiledDFA &dfa) : dfa(dfa) {}
+
+    bool null() {
+        return true;
+    }
+
+    bool boolean(bool value) {
+        if (inElement() && section == States) {
+            if (currentKey == "starting") {
+                starting = value;
+            } else if (currentKey == "accepting") {
+                accepting = value;
+            }
+        }
+        return true;
+    }
+
+    bool number_integer(json::number_integer_t) {
+        return true;
+    }
+
+    bool number_unsigned(json::number_unsigned_t) {
+        return true;
+    }
+
+    bool number_float(json::number_float_t, const std::string &) {
+        return true;
+    }
+
+    bool string(std::string &value) {
+        if (depth == 2 && section == Alphabet) {
+            // Zoals de DFA-constructor: elk karakter van de letter is een symbool
+            for (char c : value) {
+                dfa.addSymbol(c);
+            }
+        } else if (inElement()) {
+            if (section == States && currentKey == "name") {
+                name.swap(value);
+                hasName = true;
+            } else if (section == Transitions && currentKey == "from") {
+                from.swap(value);
+                hasFrom = true;
+            } else if (section == Transitions && currentKey == "to") {
+                to.swap(value);
+                hasTo = true;
+            } else if (section == Transitions && currentKey == "input") {
+                input.swap(value);
+                hasInput = !input.empty();
+            }
+        }
+        return true;
+    }
+
+    bool start_object(size_t) {
+        ++depth;
+        if (inElement()) {
+            hasName = hasFrom = hasTo = hasInput = false;
+            starting = accepting = false;
+        }
+        return true;
+    }
+
+    bool key(std::string &value) {
+        if (depth == 1) {
+            if (value == "alphabet") {
+                section = Alphabet;
+            } else if (value == "states") {
+                section = States;
+            } else if (value == "transitions") {
+                section = Transitions;
+            } else {
+                section = None;
+            }
+        } else if (inElement()) {
+            currentKey.swap(value);
+        }
+        return true;
+    }
+
+    bool end_object() {
+        if (inElement()) {
+            if (section == States) {
+                finishState();
+            } else {
+                finishTransition();
+            }
+        }
+        --depth;
+        return true;
+    }
+
+    bool start_array(size_t) {
+        ++depth;
+        return true;
+    }
+
+    bool end_array() {
+        --depth;
+        return true;
+    }
+
+    template <class Exception>
+    bool parse_error(size_t, const std::string &, const Exception &exception) {
+        throw exception;
+    }
+};
+
+CompiledDFA loadCompiledDFA(const string &inputFile) {
+    ifstream input(inputFile, ios::binary);
+    if (!input) {
+        throw runtime_error("cannot open " + inputFile);
+    }
+    return loadCompiledDFA(input);
+}
+
+CompiledDFA loadCompiledDFA(istream &input) {
+    TraceSpan span("parse");
+    TFA_STATS_TIMER(loadNanos);
+    CompiledDFA dfa;
+    DFASaxHandler handler(dfa);
+    json::sax_parse(input, &handler);
+    TFA_STATS_ADD(loads, 1);
+    TFA_STATS_ADD(loadedStates, dfa.getStateCount());
+    return dfa;
+}
+
+CompiledDFA parseCompiledDFA(const string &document) {
+    TraceSpan span("parse");
+    TFA_STATS_TIMER(loadNanos);
+    CompiledDFA dfa;
+    DFASaxHandler handler(dfa);
+    json::sax_parse(document.begin(), document.end(), &handler);
+    TFA_STATS_ADD(loads, 1);
+    TFA_STATS_ADD(loadedStates, dfa.getStateCount());
+    return dfa;
+}
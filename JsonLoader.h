@@ -0,0 +1,26 @@
+//
+// Streaming (SAX) loader from the JSON input format straight into a CompiledDFA.
+//
+
+#ifndef TABLEFILLINGALGORITHM_JSONLOADER_H
+#define TABLEFILLINGALGORITHM_JSONLOADER_H
+
+#include <istream>
+#include <string>
+#include "CompiledDFA.h"
+
+using namespace std;
+
+
+// Reads the same format as DFA(const string inputFile) without building a json DOM: state names
+// are interned as they are read and every transition is written directly into the transition
+// table, so peak memory is the compiled automaton plus one name index. The keys of the top
+// level object may come in any order. Throws nlohmann::json::parse_error on malformed JSON and
+// runtime_error on a structurally invalid automaton.
+CompiledDFA loadCompiledDFA(const string &inputFile);
+CompiledDFA loadCompiledDFA(istream &input);
+// Same, for a document that is already in memory
+CompiledDFA parseCompiledDFA(const string &document);
+
+
+#endif //TABLEFILLINGALGORITHM_JSONLOADER_H
@@ -0,0 +1,283 @@
+//
+// Streaming writer for the JSON output format of DFA::print(), without building a json DOM.
+//
+
+#include "JsonWriter.h"
+#include <cerrno>
+#include <cstring>
+#include <string_view>
+#include <stdexcept>
+#include <unistd.h>
+#include <unordered_set>
+using namespace std;
+
+// Buffers naar een ostream
+class StreamSink {
+private:
+    ostream &output;
+    char buffer[1 << 16];
+    size_t used = 0;
+
+public:
+    explicit StreamSink(ostream &output) : output(output) {}
+
+    ~StreamSink() {
+        flush();
+    }
+
+    void append(const char *bytes, size_t length) {
+        if (length > sizeof(buffer) - used) {
+            flush();
+            if (length > sizeof(buffer)) {
+                output.write(bytes, length);
+                return;
+            }
+        }
+        memcpy(buffer + used, bytes, length);
+        used += length;
+    }
+
+    void flush() {
+        output.write(buffer, used);
+        used = 0;
+    }
+};
+
+// Buffers naar een file descriptor
+class FileDescriptorSink {
+private:
+    int fd;
+    char buffer[1 << 16];
+    size_t used = 0;
+
+    void writeAll(const char *bytes, size_t length) {
+        while (length > 0) {
+            ssize_t written = ::write(fd, bytes, length);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw runtime_error(string("write failed: ") + strerror(errno));
+            }
+            bytes += written;
+            length -= written;
+        }
+    }
+
+public:
+    explicit FileDescriptorSink(int fd) : fd(fd) {}
+
+    void append(const char *bytes, size_t length) {
+        if (length > sizeof(buffer) - used) {
+            flush();
+            if (length > sizeof(buffer)) {
+                writeAll(bytes, length);
+                return;
+            }
+        }
+        memcpy(buffer + used, bytes, length);
+        used += length;
+    }
+
+    void flush() {
+        writeAll(buffer, used);
+        used = 0;
+    }
+};
+
+template <typename Sink>
+class JsonEmitter {
+private:
+    Sink &sink;
+    bool compact;
+
+public:
+    JsonEmitter(Sink &sink, bool compact) : sink(sink), compact(compact) {}
+
+    void raw(const char *text) {
+        sink.append(text, strlen(text));
+    }
+
+    void newline(int level) {
+        static const char spaces[] = "\n                ";
+        if (!compact) {
+            // Maximaal niveau 3 in dit formaat
+            sink.append(spaces, 1 + 4 * level);
+        }
+    }
+
+    // "name": of "name":  (pretty met spatie), met komma ervoor als het niet het eerste lid is
+    void key(const char *name, int level, bool first) {
+        if (!first) {
+            raw(",");
+        }
+        newline(level);
+        raw("\"");
+        raw(name);
+        raw(compact ? "\":" : "\": ");
+    }
+
+    void boolean(bool value) {
+        raw(value ? "true" : "false");
+    }
+
+    void quoted(const char *text, size_t length) {
+        static const char hex[] = "0123456789abcdef";
+        raw("\"");
+        size_t start = 0;
+        for (size_t i = 0; i < length; ++i) {
+            unsigned char c = text[i];
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;
+            }
+            sink.append(text + start, i - start);
+            start = i + 1;
+            switch (c) {
+                case '"': raw("\\\""); break;
+                case '\\': raw("\\\\"); break;
+                case '\b': raw("\\b"); break;
+                case '\f': raw("\\f"); break;
+                case '\n': raw("\\n"); break;
+                case '\r': raw("\\r"); break;
+                case '\t': raw("\\t"); break;
+                default: {
+                    char escaped[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                    sink.append(escaped, sizeof(escaped));
+                }
+            }
+        }
+        sink.append(text + start, length - start);
+        raw("\"");
+    }
+
+    void quoted(string_view text) {
+        quoted(text.data(), text.size());
+    }
+
+    // Start van een element in een array op niveau level
+    void element(int level, bool first) {
+        if (!first) {
+            raw(",");
+        }
+        newline(level);
+    }
+
+    void endArray(int level, bool empty) {
+        if (!empty) {
+            newline(level);
+        }
+        raw("]");
+    }
+};
+
+// De vaste structuur van het formaat, met de sleutels in de volgorde van nlohmann::json (gesorteerd).
+// forEachState(f) roept f(name, starting, accepting) op, forEachTransition(f) roept f(from, input, to) op.
+template <typename Sink, typename States, typename Transitions>
+static void emitDFA(Sink &sink, bool compact, const vector<char> &alfabet, States forEachState,
+                    Transitions forEachTransition) {
+    JsonEmitter<Sink> json(sink, compact);
+    json.raw("{");
+
+    json.key("alphabet", 1, true);
+    json.raw("[");
+    for (size_t i = 0; i < alfabet.size(); ++i) {
+        json.element(2, i == 0);
+        json.quoted(&alfabet[i], 1);
+    }
+    json.endArray(1, alfabet.empty());
+
+    json.key("states", 1, false);
+    json.raw("[");
+    bool first = true;
+    forEachState([&](string_view name, bool starting, bool accepting) {
+        json.element(2, first);
+        first = false;
+        json.raw("{");
+        json.key("accepting", 3, true);
+        json.boolean(accepting);
+        json.key("name", 3, false);
+        json.quoted(name);
+        json.key("starting", 3, false);
+        json.boolean(starting);
+        json.newline(2);
+        json.raw("}");
+    });
+    json.endArray(1, first);
+
+    json.key("transitions", 1, false);
+    json.raw("[");
+    first = true;
+    forEachTransition([&](string_view from, char input, string_view to) {
+        json.element(2, first);
+        first = false;
+        json.raw("{");
+        json.key("from", 3, true);
+        json.quoted(from);
+        json.key("input", 3, false);
+        json.quoted(&input, 1);
+        json.key("to", 3, false);
+        json.quoted(to);
+        json.newline(2);
+        json.raw("}");
+    });
+    json.endArray(1, first);
+
+    json.key("type", 1, false);
+    json.quoted("DFA", 3);
+    json.newline(0);
+    json.raw("}");
+}
+
+template <typename Sink>
+static void emitDFA(Sink &sink, bool compact, const DFA &dfa) {
+    unordered_set<string> acceptStates(dfa.getAcceptStates().begin(), dfa.getAcceptStates().end());
+    emitDFA(sink, compact, dfa.getAlfabet(), [&](auto state) {
+        for (const auto &name : dfa.getStates()) {
+            state(name, name == dfa.getStartState(), acceptStates.count(name) > 0);
+        }
+    }, [&](auto transition) {
+        for (const auto &entry : dfa.getTransitionFunction()) {
+            transition(entry.first.first, entry.first.second, entry.second);
+        }
+    });
+}
+
+template <typename Sink>
+static void emitDFA(Sink &sink, bool compact, const CompiledDFA &dfa) {
+    emitDFA(sink, compact, dfa.getAlfabet(), [&](auto state) {
+        for (uint32_t index = 0; index < dfa.getStateCount(); ++index) {
+            state(dfa.getStateName(index), index == dfa.getStartState(), dfa.isAccepting(index));
+        }
+    }, [&](auto transition) {
+        for (uint32_t from = 0; from < dfa.getStateCount(); ++from) {
+            for (size_t symbol = 0; symbol < dfa.getAlfabet().size(); ++symbol) {
+                uint32_t to = dfa.getTransition(from, symbol);
+                if (to != CompiledDFA::deadState) {
+                    transition(dfa.getStateName(from), dfa.getAlfabet()[symbol], dfa.getStateName(to));
+                }
+            }
+        }
+    });
+}
+
+void writeDFAJson(const DFA &dfa, ostream &output, bool compact) {
+    StreamSink sink(output);
+    emitDFA(sink, compact, dfa);
+}
+
+void writeDFAJson(const DFA &dfa, int fd, bool compact) {
+    FileDescriptorSink sink(fd);
+    emitDFA(sink, compact, dfa);
+    sink.flush();
+}
+
+void writeDFAJson(const CompiledDFA &dfa, ostream &output, bool compact) {
+    StreamSink sink(output);
+    emitDFA(sink, compact, dfa);
+}
+
+void writeDFAJson(const CompiledDFA &dfa, int fd, bool compact) {
+    FileDescriptorSink sink(fd);
+    emitDFA(sink, compact, dfa);
+    sink.flush();
+}
@@ -0,0 +1,27 @@
+//
+// Streaming writer for the JSON output format of DFA::print(), without building a json DOM.
+//
+
+#ifndef TABLEFILLINGALGORITHM_JSONWRITER_H
+#define TABLEFILLINGALGORITHM_JSONWRITER_H
+
+#include <ostream>
+#include "CompiledDFA.h"
+#include "DFA.h"
+
+using namespace std;
+
+
+// The pretty output is byte for byte what `cout << setw(4) << json` produced for the DOM that
+// print() used to build (keys sorted, four spaces indentation); compact matches json::dump().
+// No trailing newline is written. Strings are escaped like nlohmann::json does, except that
+// invalid UTF-8 is written as is instead of throwing.
+void writeDFAJson(const DFA &dfa, ostream &output, bool compact = false);
+void writeDFAJson(const DFA &dfa, int fd, bool compact = false);
+// Same format for the integer form, states in index order and transitions per state in
+// alphabet order
+void writeDFAJson(const CompiledDFA &dfa, ostream &output, bool compact = false);
+void writeDFAJson(const CompiledDFA &dfa, int fd, bool compact = false);
+
+
+#endif //TABLEFILLINGALGORITHM_JSONWRITER_H
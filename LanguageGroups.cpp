@@ -0,0 +1,66 @@
+//
+// Grouping of many automata by the language they accept.
+//
+
+#include "LanguageGroups.h"
+#include <atomic>
+#include <memory_resource>
+#include <unordered_map>
+#include "ThreadPool.h"
+using namespace std;
+
+template <typename Compile>
+static vector<LanguageGroup> groupCanonicalForms(size_t count, Compile compile, unsigned threadCount) {
+    // 1. Canonieke vorm en fingerprint van elke automaat, parallel
+    vector<CompiledDFA> canonicalForms(count);
+    vector<Fingerprint> fingerprints(count);
+    {
+        ThreadPool pool(threadCount);
+        atomic<size_t> next{0};
+        for (unsigned i = 0; i < pool.getThreadCount(); ++i) {
+            pool.submit([&] {
+                // Eigen arena per thread: de tijdelijke buffers raken de globale heap niet
+                pmr::unsynchronized_pool_resource arena;
+                for (size_t index = next++; index < count; index = next++) {
+                    canonicalForms[index] = compile(index).canonical(&arena);
+                    fingerprints[index] = hash128(canonicalForms[index].serialize());
+                }
+            });
+        }
+        pool.wait();
+    }
+
+    // 2. Emmers per fingerprint. Binnen een emmer bevestigt een lineaire vergelijking van de
+    // canonieke vormen de gelijkheid; enkel bij een botsing ontstaat er een tweede groep
+    vector<LanguageGroup> groups;
+    unordered_map<Fingerprint, vector<size_t>> groupsByFingerprint;
+    for (size_t index = 0; index < count; ++index) {
+        vector<size_t> &candidates = groupsByFingerprint[fingerprints[index]];
+        bool added = false;
+        for (size_t group : candidates) {
+            size_t representative = groups[group].members.front();
+            if (canonicalForms[representative].isIdenticalTo(canonicalForms[index])) {
+                groups[group].members.push_back(index);
+                added = true;
+                break;
+            }
+        }
+        if (!added) {
+            candidates.push_back(groups.size());
+            groups.push_back({fingerprints[index], {index}});
+        }
+    }
+    return groups;
+}
+
+vector<LanguageGroup> groupByLanguage(const vector<CompiledDFA> &dfas, unsigned threadCount) {
+    return groupCanonicalForms(dfas.size(), [&](size_t index) -> const CompiledDFA & {
+        return dfas[index];
+    }, threadCount);
+}
+
+vector<LanguageGroup> groupByLanguage(const vector<DFA> &dfas, unsigned threadCount) {
+    return groupCanonicalForms(dfas.size(), [&](size_t index) {
+        return CompiledDFA(dfas[index]);
+    }, threadCount);
+}
@@ -0,0 +1,30 @@
+//
+// Grouping of many automata by the language they accept.
+//
+
+#ifndef TABLEFILLINGALGORITHM_LANGUAGEGROUPS_H
+#define TABLEFILLINGALGORITHM_LANGUAGEGROUPS_H
+
+#include <vector>
+#include "CompiledDFA.h"
+#include "DFA.h"
+#include "Fingerprint.h"
+
+using namespace std;
+
+
+struct LanguageGroup {
+    Fingerprint fingerprint;
+    // Indices into the input, in increasing order
+    vector<size_t> members;
+};
+
+// Minimizes and canonicalizes every input on threadCount threads (0 = all cores) and buckets
+// them by fingerprint. Within a bucket the canonical forms are compared, so a hash collision
+// splits the bucket instead of merging different languages. Groups are ordered by their
+// first member.
+vector<LanguageGroup> groupByLanguage(const vector<CompiledDFA> &dfas, unsigned threadCount = 0);
+vector<LanguageGroup> groupByLanguage(const vector<DFA> &dfas, unsigned threadCount = 0);
+
+
+#endif //TABLEFILLINGALGORITHM_LANGUAGEGROUPS_H
@@ -0,0 +1,159 @@
+//
+// Generates a self-contained C++ header with a matcher function for a DFA.
+//
+
+#include "MatcherGenerator.h"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+using namespace std;
+
+static bool isIdentifier(const string &name) {
+    if (name.empty() || isdigit((unsigned char) name[0])) {
+        return false;
+    }
+    return all_of(name.begin(), name.end(), [](char c) { return isalnum((unsigned char) c) || c == '_'; });
+}
+
+// 'a' voor leesbare tekens, anders de waarde als unsigned char
+static string caseLabel(unsigned char c) {
+    if (c >= 0x20 && c < 0x7F && c != '\'' && c != '\\') {
+        return string("'") + char(c) + "'";
+    }
+    return to_string(c);
+}
+
+// Symbolen gesorteerd op bytewaarde, zodat de uitvoer niet van de volgorde van het alfabet afhangt
+static vector<int> sortedSymbols(const CompiledDFA &dfa) {
+    vector<int> symbols(dfa.getAlfabet().size());
+    for (size_t symbol = 0; symbol < symbols.size(); ++symbol) {
+        symbols[symbol] = symbol;
+    }
+    sort(symbols.begin(), symbols.end(), [&](int a, int b) {
+        return (unsigned char) dfa.getAlfabet()[a] < (unsigned char) dfa.getAlfabet()[b];
+    });
+    return symbols;
+}
+
+static void writeSwitchBody(const CompiledDFA &dfa, ostream &output) {
+    uint32_t start = dfa.getStartState();
+    vector<int> symbols = sortedSymbols(dfa);
+
+    // De start komt eerst en valt erin door, de andere staten in hun volgorde
+    vector<uint32_t> order = {start};
+    vector<bool> hasIncoming(dfa.getStateCount(), false);
+    for (uint32_t state = 0; state < dfa.getStateCount(); ++state) {
+        if (state != start) {
+            order.push_back(state);
+        }
+        for (int symbol : symbols) {
+            uint32_t to = dfa.getTransition(state, symbol);
+            if (to != CompiledDFA::deadState) {
+                hasIncoming[to] = true;
+            }
+        }
+    }
+
+    output << "    const char *end = input + length;\n";
+    for (uint32_t state : order) {
+        if (hasIncoming[state]) {
+            output << "state" << state << ":\n";
+        }
+        bool hasTransitions = false;
+        for (int symbol : symbols) {
+            hasTransitions = hasTransitions || dfa.getTransition(state, symbol) != CompiledDFA::deadState;
+        }
+        if (!hasTransitions) {
+            output << "    return " << (dfa.isAccepting(state) ? "input == end" : "false") << ";\n";
+            continue;
+        }
+        output << "    if (input == end) {\n"
+               << "        return " << (dfa.isAccepting(state) ? "true" : "false") << ";\n"
+               << "    }\n"
+               << "    switch (static_cast<unsigned char>(*input++)) {\n";
+        for (int symbol : symbols) {
+            uint32_t to = dfa.getTransition(state, symbol);
+            if (to != CompiledDFA::deadState) {
+                output << "        case " << caseLabel(dfa.getAlfabet()[symbol]) << ": goto state" << to << ";\n";
+            }
+        }
+        output << "        default: return false;\n"
+               << "    }\n";
+    }
+}
+
+static void writeTableBody(const CompiledDFA &dfa, ostream &output) {
+    // Kolom symbolCount en staat stateCount zijn de put: elk onbekend byte en elke ontbrekende
+    // transitie komt daar terecht
+    uint32_t stateCount = dfa.getStateCount();
+    size_t columns = dfa.getAlfabet().size() + 1;
+    const char *stateType = stateCount < 0xFF ? "std::uint8_t" : stateCount < 0xFFFF ? "std::uint16_t" : "std::uint32_t";
+    const char *columnType = columns <= 0xFF ? "std::uint8_t" : "std::uint16_t";
+
+    auto writeArray = [&](const char *type, const char *name, size_t size, auto value) {
+        output << "    static constexpr " << type << " " << name << "[" << size << "] = {";
+        for (size_t i = 0; i < size; ++i) {
+            output << (i % 16 == 0 ? "\n        " : " ") << value(i) << (i + 1 < size ? "," : "");
+        }
+        output << "\n    };\n";
+    };
+    writeArray(columnType, "columns", 256, [&](size_t byte) {
+        int symbol = dfa.getSymbolIndex(char(byte));
+        return symbol == -1 ? columns - 1 : size_t(symbol);
+    });
+    writeArray(stateType, "transitions", (size_t(stateCount) + 1) * columns, [&](size_t i) {
+        size_t state = i / columns, column = i % columns;
+        if (state == stateCount || column == columns - 1) {
+            return size_t(stateCount);
+        }
+        uint32_t to = dfa.getTransition(state, column);
+        return to == CompiledDFA::deadState ? size_t(stateCount) : size_t(to);
+    });
+    writeArray("bool", "accepting", size_t(stateCount) + 1, [&](size_t state) {
+        return state < stateCount && dfa.isAccepting(state) ? "true" : "false";
+    });
+
+    output << "    std::size_t state = " << dfa.getStartState() << ";\n"
+           << "    for (std::size_t i = 0; i < length; ++i) {\n"
+           << "        state = transitions[state * " << columns << " + columns[static_cast<unsigned char>(input[i])]];\n"
+           << "        if (state == " << stateCount << ") {\n"
+           << "            return false;\n"
+           << "        }\n"
+           << "    }\n"
+           << "    return accepting[state];\n";
+}
+
+void writeMatcherHeader(const CompiledDFA &dfa, const string &functionName, MatcherStyle style, ostream &output) {
+    if (!isIdentifier(functionName)) {
+        throw invalid_argument("not a C++ identifier: " + functionName);
+    }
+    string guard = "TFA_MATCHER_" + functionName + "_H";
+    transform(guard.begin(), guard.end(), guard.begin(), [](char c) { return toupper((unsigned char) c); });
+
+    output << "// Generated from a DFA with " << dfa.getStateCount() << " states, do not edit.\n"
+           << "\n"
+           << "#ifndef " << guard << "\n"
+           << "#define " << guard << "\n"
+           << "\n"
+           << "#include <cstddef>\n"
+           << "#include <cstdint>\n"
+           << "#include <string_view>\n"
+           << "\n"
+           << "inline bool " << functionName << "(const char *input, std::size_t length) {\n";
+    if (dfa.getStartState() == CompiledDFA::deadState) {
+        output << "    (void) input;\n"
+               << "    (void) length;\n"
+               << "    return false;\n";
+    } else if (style == MatcherStyle::Switch) {
+        writeSwitchBody(dfa, output);
+    } else {
+        writeTableBody(dfa, output);
+    }
+    output << "}\n"
+           << "\n"
+           << "inline bool " << functionName << "(std::string_view input) {\n"
+           << "    return " << functionName << "(input.data(), input.size());\n"
+           << "}\n"
+           << "\n"
+           << "#endif //" << guard << "\n";
+}
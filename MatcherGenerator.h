@@ -0,0 +1,31 @@
+//
+// Generates a self-contained C++ header with a matcher function for a DFA.
+//
+
+#ifndef TABLEFILLINGALGORITHM_MATCHERGENERATOR_H
+#define TABLEFILLINGALGORITHM_MATCHERGENERATOR_H
+
+#include <ostream>
+#include <string>
+#include "CompiledDFA.h"
+
+using namespace std;
+
+
+enum class MatcherStyle {
+    // One label per state and a switch on the next byte, jumping with goto
+    Switch,
+    // Byte -> column map and a flat transition table, smallest integer type that fits
+    Table
+};
+
+// Writes a header that only needs the standard library, declaring
+//     inline bool functionName(const char *input, std::size_t length);
+//     inline bool functionName(std::string_view input);
+// which accept exactly the words dfa accepts. The automaton is used as it is; pass
+// dfa.minimize() for the smallest code. functionName must be a C++ identifier, otherwise
+// invalid_argument is thrown.
+void writeMatcherHeader(const CompiledDFA &dfa, const string &functionName, MatcherStyle style, ostream &output);
+
+
+#endif //TABLEFILLINGALGORITHM_MATCHERGENERATOR_H
@@ -0,0 +1,121 @@
+//
+// Memory accounting of automata and of the algorithms that run on them.
+//
+
+#include "MemoryUsage.h"
+#include <algorithm>
+#include "DFA.h"
+#include "StringPool.h"
+using namespace std;
+
+size_t MemoryUsage::total() const {
+    return names + transitions + table + indices;
+}
+
+void writeMemoryUsageJson(const MemoryUsage &usage, ostream &output) {
+    output << "{\"names\": " << usage.names << ", \"transitions\": " << usage.transitions << ", \"table\": "
+           << usage.table << ", \"indices\": " << usage.indices << ", \"total\": " << usage.total() << "}";
+}
+
+PeakMemoryResource::PeakMemoryResource(pmr::memory_resource *upstream) : upstream(upstream) {}
+
+void *PeakMemoryResource::do_allocate(size_t bytes, size_t alignment) {
+    void *pointer = upstream->allocate(bytes, alignment);
+    allocations.fetch_add(1, memory_order_relaxed);
+    size_t now = current.fetch_add(bytes, memory_order_relaxed) + bytes;
+    size_t highest = peak.load(memory_order_relaxed);
+    while (now > highest && !peak.compare_exchange_weak(highest, now, memory_order_relaxed)) {
+    }
+    return pointer;
+}
+
+void PeakMemoryResource::do_deallocate(void *pointer, size_t bytes, size_t alignment) {
+    upstream->deallocate(pointer, bytes, alignment);
+    current.fetch_sub(bytes, memory_order_relaxed);
+}
+
+bool PeakMemoryResource::do_is_equal(const pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+
+size_t PeakMemoryResource::getCurrent() const {
+    return current.load(memory_order_relaxed);
+}
+
+size_t PeakMemoryResource::getPeak() const {
+    return peak.load(memory_order_relaxed);
+}
+
+size_t PeakMemoryResource::getAllocations() const {
+    return allocations.load(memory_order_relaxed);
+}
+
+void PeakMemoryResource::resetPeak() {
+    peak.store(current.load(memory_order_relaxed), memory_order_relaxed);
+    allocations.store(0, memory_order_relaxed);
+}
+
+size_t predictTableBytes(size_t stateCount) {
+    if (stateCount < 2) {
+        return 0;
+    }
+    // n - 1 rijen van n - 1 bits, elke rij een eigen vector<bool> in 64-bit woorden
+    size_t rows = stateCount - 1;
+    return rows * (sizeof(vector<bool>) + (rows + 63) / 64 * sizeof(uint64_t));
+}
+
+// Voorgangers per (symbool, staat) in constructTable, plus groei van de vectoren
+static size_t predictSourceIndexBytes(size_t stateCount, size_t symbolCount, size_t transitionCount) {
+    return symbolCount * stateCount * sizeof(vector<int>) + 2 * transitionCount * sizeof(int);
+}
+
+// trim() gaat langs CompiledDFA: een pool met minstens één blok, hoogstens twee tegelijk
+static size_t predictPoolBytes(const MemoryUsage &usage) {
+    return 2 * (StringPool::blockSize + usage.names);
+}
+
+size_t predictMinimizeBytes(DFA &dfa) {
+    MemoryUsage usage = dfa.memoryUsage();
+    // Eén staat extra voor de put van een partiële DFA, alle transities naar die put erbij
+    size_t stateCount = dfa.getStates().size() + 1;
+    size_t symbolCount = dfa.getAlfabet().size();
+    size_t transitionBytes = dfa.getTransitionFunction().empty() ? 0
+                             : usage.transitions / dfa.getTransitionFunction().size() + sizeof(string);
+    size_t completed = usage.names + usage.indices + stateCount * symbolCount * transitionBytes;
+
+    // Het quotiënt houdt elk paar equivalente staten bij als vector<string> met twee namen (in
+    // een vector die bij het groeien even drie keer zo groot is)
+    size_t pairs = stateCount * (stateCount - 1) / 2;
+    if (dfa.hasTable()) {
+        pairs = 0;
+        // Enkel de benedendriehoek (kolom <= rij) wordt gebruikt
+        const vector<vector<bool>> &table = dfa.getTable();
+        for (size_t row = 0; row < table.size(); ++row) {
+            pairs += count(table[row].begin(), table[row].begin() + row + 1, false);
+        }
+    }
+    size_t nameLength = 0;
+    for (const auto &state : dfa.getStates()) {
+        nameLength += state.size() + 2;
+    }
+    nameLength /= stateCount;
+    size_t pairBytes = 3 * sizeof(vector<string>) + 2 * (sizeof(string) + nameLength);
+    // Wachtrij en verzameling van het quotiënt: een naam per klasse, en een klasse kan alle staten bevatten
+    size_t queueBytes = 2 * stateCount * (sizeof(string) + stateCount * nameLength);
+
+    // De tabel bestaat even twee keer (lokaal en de kopie in de DFA); trim, de aangevulde kopie
+    // en het resultaat zijn elk hoogstens zo groot als de invoer, de namen van het quotiënt
+    // hoogstens twee keer
+    return 2 * predictTableBytes(stateCount) + predictSourceIndexBytes(stateCount, symbolCount, stateCount * symbolCount)
+           + 4 * completed + usage.names + predictPoolBytes(usage) + pairs * pairBytes + queueBytes;
+}
+
+size_t predictEquivalenceBytes(const DFA &lhs, const DFA &rhs) {
+    MemoryUsage left = lhs.memoryUsage(), right = rhs.memoryUsage();
+    size_t withoutTables = left.total() - left.table + right.total() - right.table;
+    size_t stateCount = lhs.getStates().size() + rhs.getStates().size();
+    size_t symbolCount = lhs.getAlfabet().size() + rhs.getAlfabet().size();
+    // Beide getrimd, de samengevoegde DFA en de kopieën van de transitiefuncties
+    return 2 * predictTableBytes(stateCount) + predictSourceIndexBytes(stateCount, symbolCount, stateCount * symbolCount)
+           + 4 * withoutTables + predictPoolBytes(left) + predictPoolBytes(right);
+}
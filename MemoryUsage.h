@@ -0,0 +1,76 @@
+//
+// Memory accounting of automata and of the algorithms that run on them.
+//
+
+#ifndef TABLEFILLINGALGORITHM_MEMORYUSAGE_H
+#define TABLEFILLINGALGORITHM_MEMORYUSAGE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <ostream>
+
+using namespace std;
+
+class DFA;
+
+
+// Heap bytes owned by an automaton, including the bookkeeping of the containers (map nodes,
+// string buffers, vector capacity), so it is close to what the allocator hands out.
+struct MemoryUsage {
+    // State names (DFA: the strings in states, acceptStates and the map; CompiledDFA: its pool)
+    size_t names = 0;
+    // Transition function
+    size_t transitions = 0;
+    // The cached table of DFA::getTable(), n^2 / 2 bits; see DFA::releaseTable()
+    size_t table = 0;
+    // Alphabet, symbol indexes, accept flags and name ids
+    size_t indices = 0;
+
+    size_t total() const;
+};
+
+// {"names": ..., "transitions": ..., "table": ..., "indices": ..., "total": ...}
+void writeMemoryUsageJson(const MemoryUsage &usage, ostream &output);
+
+// Forwards to upstream and counts what is live, the highest value that reached and the number
+// of allocations; pass it as the scratch resource of an algorithm to see what it used. Safe to
+// share between threads. It only sees the scratch buffers: the table, the copies and the result
+// of minimize() come from the default heap. The whole peak is measured by HeapCounter.h, which
+// TableFillingBenchmark reports for minimize and equals.
+class PeakMemoryResource : public pmr::memory_resource {
+private:
+    pmr::memory_resource *upstream;
+    atomic<size_t> current{0};
+    atomic<size_t> peak{0};
+    atomic<size_t> allocations{0};
+
+protected:
+    void *do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void *pointer, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const pmr::memory_resource &other) const noexcept override;
+
+public:
+    explicit PeakMemoryResource(pmr::memory_resource *upstream = pmr::get_default_resource());
+
+    size_t getCurrent() const;
+    size_t getPeak() const;
+    size_t getAllocations() const;
+    // Peak back to the current value, allocations to 0
+    void resetPeak();
+};
+
+// Bytes of the table constructTable() builds for stateCount states, before building it
+size_t predictTableBytes(size_t stateCount);
+
+// Upper bounds of the extra heap that DFA::minimize() and DFA::equals() need on top of their
+// inputs: the table on the (trimmed, possibly completed) states, the transition index of the
+// table construction and the copies the algorithms make. Meant to size workers before a job
+// runs. The quotient of minimize() keeps every pair of equivalent states, which is quadratic for
+// automata with many equivalent states; without a cached table (DFA::hasTable()) every pair is
+// assumed equivalent, after getTable() the bound uses the actual pairs and is much tighter.
+size_t predictMinimizeBytes(DFA &dfa);
+size_t predictEquivalenceBytes(const DFA &lhs, const DFA &rhs);
+
+
+#endif //TABLEFILLINGALGORITHM_MEMORYUSAGE_H
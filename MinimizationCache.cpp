@@ -0,0 +1,136 @@
+//
+// Content-addressed on-disk cache of minimization results.
+//
+
+#include "MinimizationCache.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include "CompiledDFA.h"
+using namespace std;
+
+namespace fs = std::filesystem;
+
+// Verhoog bij elke wijziging aan DFA::minimize() of aan het formaat, oude entries worden dan genegeerd
+static const uint64_t cacheVersion = 1;
+
+MinimizationCache::MinimizationCache(const string &directory) : directory(directory) {}
+
+Fingerprint MinimizationCache::keyFor(const DFA &dfa) {
+    string normalized;
+    auto putString = [&](const string &value) {
+        normalized += to_string(value.size());
+        normalized += ':';
+        normalized += value;
+    };
+
+    // Het alfabet blijft in zijn volgorde: minimize() overloopt de symbolen in die volgorde
+    putString(string(dfa.getAlfabet().begin(), dfa.getAlfabet().end()));
+    putString(dfa.getStartState());
+
+    vector<string> states = dfa.getStates();
+    sort(states.begin(), states.end());
+    normalized += to_string(states.size()) + ';';
+    for (const auto &state : states) {
+        putString(state);
+        normalized += dfa.isAcceptingState(state) ? '1' : '0';
+    }
+
+    // De map is al gesorteerd op (van, symbool)
+    normalized += to_string(dfa.getTransitionFunction().size()) + ';';
+    for (const auto &transition : dfa.getTransitionFunction()) {
+        putString(transition.first.first);
+        normalized += transition.first.second;
+        putString(transition.second);
+    }
+
+    return hash128(normalized, cacheVersion);
+}
+
+bool MinimizationCache::lookup(const Fingerprint &key, DFA &minimized) const {
+    ifstream input(getEntryPath(key), ios::binary);
+    if (!input) {
+        return false;
+    }
+    stringstream contents;
+    contents << input.rdbuf();
+
+    CompiledDFA compiled;
+    if (!CompiledDFA::deserialize(contents.str(), compiled)) {
+        return false;
+    }
+    minimized = compiled.toDFA();
+    return true;
+}
+
+void MinimizationCache::store(const Fingerprint &key, const DFA &minimized) const {
+    string path = getEntryPath(key);
+    error_code error;
+    fs::create_directories(fs::path(path).parent_path(), error);
+    if (error) {
+        return;
+    }
+
+    // Schrijf naar een tijdelijk bestand en hernoem, zodat lezers nooit een half bestand zien
+    static atomic<unsigned> counter{0};
+    stringstream temporary;
+    temporary << path << ".tmp." << hash<thread::id>()(this_thread::get_id()) << '.' << counter++;
+    {
+        ofstream output(temporary.str(), ios::binary | ios::trunc);
+        string bytes = CompiledDFA(minimized).serialize(true);
+        output.write(bytes.data(), bytes.size());
+        if (!output) {
+            output.close();
+            fs::remove(temporary.str(), error);
+            return;
+        }
+    }
+    fs::rename(temporary.str(), path, error);
+    if (error) {
+        fs::remove(temporary.str(), error);
+    }
+}
+
+bool MinimizationCache::lookup(const DFA &dfa, DFA &minimized) const {
+    return lookup(keyFor(dfa), minimized);
+}
+
+void MinimizationCache::store(const DFA &dfa, const DFA &minimized) const {
+    store(keyFor(dfa), minimized);
+}
+
+const string &MinimizationCache::getDirectory() const {
+    return directory;
+}
+
+string MinimizationCache::getEntryPath(const Fingerprint &key) const {
+    string hex = key.toHex();
+    return (fs::path(directory) / hex.substr(0, 2) / (hex + ".min")).string();
+}
+
+static mutex defaultCacheMutex;
+static shared_ptr<MinimizationCache> defaultCache;
+static bool defaultCacheInitialised = false;
+
+shared_ptr<const MinimizationCache> MinimizationCache::getDefault() {
+    lock_guard<mutex> lock(defaultCacheMutex);
+    if (!defaultCacheInitialised) {
+        const char *environment = getenv("TFA_CACHE_DIR");
+        if (environment != nullptr && *environment != '\0') {
+            defaultCache = make_shared<MinimizationCache>(environment);
+        }
+        defaultCacheInitialised = true;
+    }
+    return defaultCache;
+}
+
+void MinimizationCache::setDefaultDirectory(const string &directory) {
+    lock_guard<mutex> lock(defaultCacheMutex);
+    defaultCache = directory.empty() ? nullptr : make_shared<MinimizationCache>(directory);
+    defaultCacheInitialised = true;
+}
@@ -0,0 +1,46 @@
+//
+// Content-addressed on-disk cache of minimization results.
+//
+
+#ifndef TABLEFILLINGALGORITHM_MINIMIZATIONCACHE_H
+#define TABLEFILLINGALGORITHM_MINIMIZATIONCACHE_H
+
+#include <memory>
+#include <string>
+#include "DFA.h"
+#include "Fingerprint.h"
+
+using namespace std;
+
+
+// Every entry is stored as <directory>/<first 2 hex digits>/<key>.min, where the key is the hash
+// of the normalized input DFA and the contents are CompiledDFA::serialize(true) of the result of
+// DFA::minimize(). Entries are written to a temporary file and renamed, so concurrent builds
+// sharing a directory never see half written entries. Unreadable or corrupt entries are misses.
+class MinimizationCache {
+private:
+    string directory;
+
+public:
+    explicit MinimizationCache(const string &directory);
+
+    // Hash of the input DFA with its states, accepting states and transitions in sorted order,
+    // so the order in which the JSON lists them does not matter
+    static Fingerprint keyFor(const DFA &dfa);
+
+    bool lookup(const Fingerprint &key, DFA &minimized) const;
+    void store(const Fingerprint &key, const DFA &minimized) const;
+    bool lookup(const DFA &dfa, DFA &minimized) const;
+    void store(const DFA &dfa, const DFA &minimized) const;
+
+    const string &getDirectory() const;
+    string getEntryPath(const Fingerprint &key) const;
+
+    // Cache used by DFA::minimize(). Initialised from the TFA_CACHE_DIR environment variable,
+    // nullptr (no caching) when that is not set; an empty directory disables the cache again.
+    static shared_ptr<const MinimizationCache> getDefault();
+    static void setDefaultDirectory(const string &directory);
+};
+
+
+#endif //TABLEFILLINGALGORITHM_MINIMIZATIONCACHE_H
@@ -0,0 +1,35 @@
+//
+// Counters and phase timers of loading and table-filling minimization.
+//
+
+#include "MinimizationStats.h"
+using namespace std;
+
+MinimizationStatsCounters &minimizationStatsCounters() {
+    static MinimizationStatsCounters counters;
+    return counters;
+}
+
+MinimizationStats getMinimizationStats() {
+    MinimizationStats stats;
+    MinimizationStatsCounters &counters = minimizationStatsCounters();
+#define TFA_STATS_FIELD(name) stats.name = counters.name.load(memory_order_relaxed);
+    TFA_MINIMIZATION_STATS(TFA_STATS_FIELD)
+#undef TFA_STATS_FIELD
+    return stats;
+}
+
+void resetMinimizationStats() {
+    MinimizationStatsCounters &counters = minimizationStatsCounters();
+#define TFA_STATS_FIELD(name) counters.name.store(0, memory_order_relaxed);
+    TFA_MINIMIZATION_STATS(TFA_STATS_FIELD)
+#undef TFA_STATS_FIELD
+}
+
+void writeMinimizationStatsJson(const MinimizationStats &stats, ostream &output) {
+    output << "{\"enabled\": " << (minimizationStatsEnabled() ? "true" : "false");
+#define TFA_STATS_FIELD(name) output << ", \"" #name "\": " << stats.name;
+    TFA_MINIMIZATION_STATS(TFA_STATS_FIELD)
+#undef TFA_STATS_FIELD
+    output << "}";
+}
@@ -0,0 +1,126 @@
+//
+// Counters and phase timers of loading and table-filling minimization.
+//
+
+#ifndef TABLEFILLINGALGORITHM_MINIMIZATIONSTATS_H
+#define TABLEFILLINGALGORITHM_MINIMIZATIONSTATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory_resource>
+#include <ostream>
+
+using namespace std;
+
+
+// Every field, in the order of the JSON dump. The *Nanos fields are wall-clock time spent in a
+// phase, summed over all threads; nested phases (trim inside minimize) are counted in both.
+#define TFA_MINIMIZATION_STATS(X) \
+    X(loads)                      \
+    X(loadedStates)               \
+    X(loadNanos)                  \
+    X(minimizations)              \
+    X(cacheHits)                  \
+    X(cacheNanos)                 \
+    X(trimmedStates)              \
+    X(trimNanos)                  \
+    X(completedTransitions)       \
+    X(tables)                     \
+    X(tableCells)                 \
+    X(initialMarks)               \
+    X(fixpointRounds)             \
+    X(pairsMarked)                \
+    X(findSourceStatesCalls)      \
+    X(sourcePairs)                \
+    X(tableNanos)                 \
+    X(quotientStates)             \
+    X(quotientNanos)              \
+    X(scratchAllocations)         \
+    X(scratchBytes)               \
+    X(minimizeNanos)
+
+// Snapshot of the process-wide totals. Only filled when the library is built with
+// TFA_ENABLE_STATS (CMake option of the same name); otherwise every field stays 0 and the
+// instrumentation compiles away.
+struct MinimizationStats {
+#define TFA_STATS_FIELD(name) uint64_t name = 0;
+    TFA_MINIMIZATION_STATS(TFA_STATS_FIELD)
+#undef TFA_STATS_FIELD
+};
+
+constexpr bool minimizationStatsEnabled() {
+#ifdef TFA_ENABLE_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+MinimizationStats getMinimizationStats();
+void resetMinimizationStats();
+// {"enabled": ..., "loads": ..., ...}, one member per field
+void writeMinimizationStatsJson(const MinimizationStats &stats, ostream &output);
+
+// De tellers zelf, enkel voor de macro's hieronder
+struct MinimizationStatsCounters {
+#define TFA_STATS_FIELD(name) atomic<uint64_t> name{0};
+    TFA_MINIMIZATION_STATS(TFA_STATS_FIELD)
+#undef TFA_STATS_FIELD
+};
+MinimizationStatsCounters &minimizationStatsCounters();
+
+// Telt de tijd tot het einde van de scope bij een timer op
+class StatsTimer {
+private:
+    atomic<uint64_t> &nanos;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+public:
+    explicit StatsTimer(atomic<uint64_t> &nanos) : nanos(nanos) {}
+    ~StatsTimer() {
+        nanos.fetch_add(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count(),
+                        memory_order_relaxed);
+    }
+
+    StatsTimer(const StatsTimer &) = delete;
+    StatsTimer &operator=(const StatsTimer &) = delete;
+};
+
+// Telt de allocaties die door een scratch resource gaan
+class CountingResource : public pmr::memory_resource {
+private:
+    pmr::memory_resource *upstream;
+
+protected:
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        minimizationStatsCounters().scratchAllocations.fetch_add(1, memory_order_relaxed);
+        minimizationStatsCounters().scratchBytes.fetch_add(bytes, memory_order_relaxed);
+        return upstream->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *pointer, size_t bytes, size_t alignment) override {
+        upstream->deallocate(pointer, bytes, alignment);
+    }
+    bool do_is_equal(const pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+public:
+    explicit CountingResource(pmr::memory_resource *upstream) : upstream(upstream) {}
+};
+
+// Hete lussen tellen in een lokale variabele en tellen die één keer op met TFA_STATS_ADD
+#ifdef TFA_ENABLE_STATS
+#define TFA_STATS_CONCAT2(a, b) a##b
+#define TFA_STATS_CONCAT(a, b) TFA_STATS_CONCAT2(a, b)
+#define TFA_STATS_ADD(counter, amount) \
+    minimizationStatsCounters().counter.fetch_add((amount), memory_order_relaxed)
+#define TFA_STATS_TIMER(timer) \
+    StatsTimer TFA_STATS_CONCAT(tfaStatsTimer, __LINE__)(minimizationStatsCounters().timer)
+#else
+#define TFA_STATS_ADD(counter, amount) ((void) 0)
+#define TFA_STATS_TIMER(timer) ((void) 0)
+#endif
+
+
+#endif //TABLEFILLINGALGORITHM_MINIMIZATIONSTATS_H
@@ -0,0 +1,131 @@
+//
+// Hardware performance counters of the calling thread through perf_event_open.
+//
+
+#include "PerfCounters.h"
+#include <cerrno>
+#include <cstring>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+const vector<string> &PerfCounters::getNames() {
+    static const vector<string> names = {"cycles", "instructions", "llcMisses", "branchMisses"};
+    return names;
+}
+
+#ifdef __linux__
+
+PerfCounters::PerfCounters() : descriptors(getNames().size(), -1), values(getNames().size(), 0) {
+    // PERF_COUNT_HW_CACHE_MISSES is de laatste cache op de meeste processoren
+    const uint64_t configs[] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+                                PERF_COUNT_HW_BRANCH_MISSES};
+    for (size_t counter = 0; counter < descriptors.size(); ++counter) {
+        perf_event_attr attributes;
+        memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.config = configs[counter];
+        attributes.disabled = 1;
+        // Zonder kernel en hypervisor volstaat perf_event_paranoid <= 2, de standaard
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        descriptors[counter] = syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+        if (descriptors[counter] == -1 && error.empty()) {
+            error = getNames()[counter] + ": " + strerror(errno);
+        }
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (int descriptor : descriptors) {
+        if (descriptor != -1) {
+            close(descriptor);
+        }
+    }
+}
+
+void PerfCounters::start() {
+    for (int descriptor : descriptors) {
+        if (descriptor != -1) {
+            ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+            ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+void PerfCounters::stop() {
+    for (size_t counter = 0; counter < descriptors.size(); ++counter) {
+        if (descriptors[counter] != -1) {
+            ioctl(descriptors[counter], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (size_t counter = 0; counter < descriptors.size(); ++counter) {
+        // value, time enabled, time running
+        uint64_t data[3] = {};
+        values[counter] = 0;
+        if (descriptors[counter] == -1 || read(descriptors[counter], data, sizeof(data)) != sizeof(data)) {
+            continue;
+        }
+        values[counter] = data[2] == 0 ? 0 : double(data[0]) * data[1] / data[2];
+    }
+}
+
+void PerfCounters::pause() {
+    for (int descriptor : descriptors) {
+        if (descriptor != -1) {
+            ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+}
+
+void PerfCounters::resume() {
+    for (int descriptor : descriptors) {
+        if (descriptor != -1) {
+            ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+#else
+
+PerfCounters::PerfCounters() : descriptors(getNames().size(), -1), values(getNames().size(), 0),
+                               error("perf_event_open is only available on Linux") {}
+
+PerfCounters::~PerfCounters() {}
+
+void PerfCounters::start() {}
+
+void PerfCounters::stop() {}
+
+void PerfCounters::pause() {}
+
+void PerfCounters::resume() {}
+
+#endif
+
+bool PerfCounters::isAvailable() const {
+    for (int descriptor : descriptors) {
+        if (descriptor != -1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const string &PerfCounters::getError() const {
+    return error;
+}
+
+bool PerfCounters::hasValue(size_t counter) const {
+    return descriptors[counter] != -1;
+}
+
+double PerfCounters::getValue(size_t counter) const {
+    return values[counter];
+}
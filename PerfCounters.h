@@ -0,0 +1,51 @@
+//
+// Hardware performance counters of the calling thread through perf_event_open.
+//
+
+#ifndef TABLEFILLINGALGORITHM_PERFCOUNTERS_H
+#define TABLEFILLINGALGORITHM_PERFCOUNTERS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+
+// Counts cycles, instructions, last-level cache misses and branch misses in user space between
+// start() and stop(). Every counter is opened on its own, so a machine that lacks one (virtual
+// machines often only have software counters) still gets the others; when the kernel refuses all
+// of them (no PMU, perf_event_paranoid > 2, not Linux) isAvailable() is false and getError() says
+// why. When the kernel multiplexes counters the values are scaled to the full interval.
+class PerfCounters {
+private:
+    vector<int> descriptors;
+    vector<double> values;
+    string error;
+
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    bool isAvailable() const;
+    const string &getError() const;
+
+    void start();
+    void stop();
+    // Between start() and stop(): stop counting without reading or resetting, and continue
+    void pause();
+    void resume();
+
+    // In the order of getNames(); false for a counter that could not be opened
+    bool hasValue(size_t counter) const;
+    double getValue(size_t counter) const;
+
+    // "cycles", "instructions", "llcMisses", "branchMisses"
+    static const vector<string> &getNames();
+};
+
+
+#endif //TABLEFILLINGALGORITHM_PERFCOUNTERS_H
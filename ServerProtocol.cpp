@@ -0,0 +1,126 @@
+//
+// Length-prefixed binary protocol between DFAServer and DFAClient.
+//
+
+#include "ServerProtocol.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+using namespace std;
+
+FrameWriter::FrameWriter() : bytes(4, '\0') {}
+
+void FrameWriter::putUint8(uint8_t value) {
+    bytes.push_back(char(value));
+}
+
+void FrameWriter::putUint32(uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        bytes.push_back(char(value >> shift));
+    }
+}
+
+void FrameWriter::putString(string_view value) {
+    if (value.size() > maxFrameSize) {
+        throw runtime_error("string too long for a frame");
+    }
+    putUint32(uint32_t(value.size()));
+    bytes.append(value);
+}
+
+string &FrameWriter::finish() {
+    uint32_t length = uint32_t(bytes.size() - 4);
+    for (int i = 0; i < 4; ++i) {
+        bytes[i] = char(length >> (8 * i));
+    }
+    return bytes;
+}
+
+FrameReader::FrameReader(string_view payload) : bytes(payload), position(0) {}
+
+uint8_t FrameReader::getUint8() {
+    if (position + 1 > bytes.size()) {
+        throw runtime_error("truncated request");
+    }
+    return uint8_t(bytes[position++]);
+}
+
+uint32_t FrameReader::getUint32() {
+    if (position + 4 > bytes.size()) {
+        throw runtime_error("truncated request");
+    }
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= uint32_t(uint8_t(bytes[position++])) << (8 * i);
+    }
+    return value;
+}
+
+string_view FrameReader::getString() {
+    uint32_t length = getUint32();
+    if (length > bytes.size() - position) {
+        throw runtime_error("truncated request");
+    }
+    string_view value = bytes.substr(position, length);
+    position += length;
+    return value;
+}
+
+bool FrameReader::atEnd() const {
+    return position == bytes.size();
+}
+
+bool sendAll(int fd, const char *data, size_t size) {
+    while (size > 0) {
+        ssize_t written = send(fd, data, size, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+// false als de stroom eindigt voor er iets gelezen is
+static bool receiveAll(int fd, char *data, size_t size) {
+    size_t received = 0;
+    while (received < size) {
+        ssize_t count = read(fd, data + received, size - received);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count < 0) {
+            throw runtime_error(string("read failed: ") + strerror(errno));
+        }
+        if (count == 0) {
+            if (received == 0) {
+                return false;
+            }
+            throw runtime_error("connection closed in the middle of a frame");
+        }
+        received += count;
+    }
+    return true;
+}
+
+bool receiveFrame(int fd, string &payload) {
+    unsigned char header[4];
+    if (!receiveAll(fd, reinterpret_cast<char *>(header), sizeof(header))) {
+        return false;
+    }
+    uint32_t length = header[0] | header[1] << 8 | header[2] << 16 | uint32_t(header[3]) << 24;
+    if (length > maxFrameSize) {
+        throw runtime_error("frame of " + to_string(length) + " bytes is too large");
+    }
+    payload.resize(length);
+    if (length > 0 && !receiveAll(fd, &payload[0], length)) {
+        throw runtime_error("connection closed in the middle of a frame");
+    }
+    return true;
+}
@@ -0,0 +1,99 @@
+//
+// Length-prefixed binary protocol between DFAServer and DFAClient.
+//
+
+#ifndef TABLEFILLINGALGORITHM_SERVERPROTOCOL_H
+#define TABLEFILLINGALGORITHM_SERVERPROTOCOL_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+
+// Every message is a frame: uint32 payload length, then the payload. Integers are little-endian
+// (like BinaryDFA, client and server run on the same host); a string is a uint32 length and its
+// bytes. A request payload is
+//   uint8 op, uint32 request id, the arguments of the op
+// and its response
+//   uint8 status, uint32 the same request id, then the results (ok) or one string (error)
+// A client may send many requests without waiting; responses carry the id of their request and
+// can come in a different order.
+//
+//   op           arguments                                   results
+//   Load         string name, uint8 source, string,          uint32 states, uint32 minimal states
+//                uint8 flags
+//   Unload       string name                                 uint8 existed
+//   Accepts      string name, uint32 n, n strings            n uint8 (0 or 1)
+//   Minimize     string name                                 string minimal DFA in the BinaryDFA format
+//   Equivalence  string name, string other                   uint8 equivalent, string witness,
+//                                                            uint8 side (0 name, 1 other)
+//   Job          string JSON job (see JobRunner.h)            string JSON result
+//   List         -                                           uint32 n, n x (string name, uint32 states)
+//
+// Load source 0 is a file path (JSON or binary), 1 a JSON document. Load replaces an automaton
+// with the same name. Flag loadJit compiles the matcher of Accepts to native code. The names in
+// a Job are resident automata first and file paths otherwise.
+enum class ServerOp : uint8_t {
+    Load = 1,
+    Unload = 2,
+    Accepts = 3,
+    Minimize = 4,
+    Equivalence = 5,
+    Job = 6,
+    List = 7
+};
+
+enum class ServerStatus : uint8_t {
+    Ok = 0,
+    Error = 1
+};
+
+const uint8_t loadFromFile = 0;
+const uint8_t loadFromJson = 1;
+const uint8_t loadJit = 1;
+
+// Larger frames are a protocol error, the connection is closed
+const uint32_t maxFrameSize = 256 << 20;
+
+// Appends to a payload
+class FrameWriter {
+private:
+    string bytes;
+
+public:
+    // Room for the length, filled in by finish()
+    FrameWriter();
+
+    void putUint8(uint8_t value);
+    void putUint32(uint32_t value);
+    void putString(string_view value);
+
+    // The frame with its length, ready to send
+    string &finish();
+};
+
+// Reads a payload; every get throws runtime_error when the payload is too short
+class FrameReader {
+private:
+    string_view bytes;
+    size_t position;
+
+public:
+    explicit FrameReader(string_view payload);
+
+    uint8_t getUint8();
+    uint32_t getUint32();
+    // Points into the payload
+    string_view getString();
+    bool atEnd() const;
+};
+
+// Whole buffer to fd, retrying short writes and EINTR; false when the peer is gone. No SIGPIPE.
+bool sendAll(int fd, const char *data, size_t size);
+// Next frame from fd into payload; false at end of stream, runtime_error on errors and oversized frames
+bool receiveFrame(int fd, string &payload);
+
+
+#endif //TABLEFILLINGALGORITHM_SERVERPROTOCOL_H
@@ -0,0 +1,259 @@
+//
+// DFA whose description, minimization and tables are all evaluated at compile time.
+//
+
+#ifndef TABLEFILLINGALGORITHM_STATICDFA_H
+#define TABLEFILLINGALGORITHM_STATICDFA_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+using namespace std;
+
+
+struct StaticState {
+    string_view name;
+    bool starting;
+    bool accepting;
+};
+
+struct StaticTransition {
+    string_view from;
+    char input;
+    string_view to;
+};
+
+// Header-only counterpart of CompiledDFA for automata that are known when the program is built:
+//
+//     constexpr StaticState states[] = {{"A", true, false}, {"B", false, true}, {"C", false, true}};
+//     constexpr StaticTransition transitions[] = {{"A", 'a', "B"}, {"B", 'a', "C"}, {"C", 'a', "B"}};
+//     constexpr auto matcher = StaticDFA(states, "a", transitions).minimize();
+//     static_assert(matcher.getStateCount() == 2 && matcher.accepts("aaa"));
+//
+// The tables are std::arrays sized by the description; minimize() keeps that size and only uses
+// the first getStateCount() rows. Errors in the description (unknown state, symbol outside the
+// alphabet) throw invalid_argument, which makes a constexpr evaluation fail to compile.
+template <size_t StateCount, size_t SymbolCount>
+class StaticDFA {
+public:
+    // Implicit sink for missing transitions, same meaning as CompiledDFA::deadState
+    static constexpr uint32_t deadState = UINT32_MAX;
+
+private:
+    array<char, SymbolCount> alfabet{};
+    // symbool -> kolom in transitions, -1 als het symbool niet in het alfabet zit
+    array<int, 256> symbolIndexes{};
+    // transitions[state * SymbolCount + symbol], deadState als er geen transitie is
+    array<uint32_t, StateCount * SymbolCount> transitions{};
+    array<bool, StateCount> accepting{};
+    uint32_t stateCount = 0;
+    uint32_t startState = deadState;
+
+    constexpr StaticDFA() {
+        for (auto &index : symbolIndexes) {
+            index = -1;
+        }
+        for (auto &to : transitions) {
+            to = deadState;
+        }
+    }
+
+    static constexpr uint32_t indexOf(const StaticState (&states)[StateCount], string_view name) {
+        for (uint32_t state = 0; state < StateCount; ++state) {
+            if (states[state].name == name) {
+                return state;
+            }
+        }
+        throw invalid_argument("transition to or from an unknown state");
+    }
+
+public:
+    // The alphabet is a string literal, one symbol per character
+    template <size_t TransitionCount>
+    constexpr StaticDFA(const StaticState (&states)[StateCount], const char (&alfabet)[SymbolCount + 1],
+                        const StaticTransition (&transitions)[TransitionCount]) : StaticDFA() {
+        for (size_t symbol = 0; symbol < SymbolCount; ++symbol) {
+            StaticDFA::alfabet[symbol] = alfabet[symbol];
+            symbolIndexes[(unsigned char) alfabet[symbol]] = symbol;
+        }
+        stateCount = StateCount;
+        for (uint32_t state = 0; state < StateCount; ++state) {
+            accepting[state] = states[state].accepting;
+            if (states[state].starting) {
+                startState = state;
+            }
+        }
+        for (const auto &transition : transitions) {
+            int symbol = symbolIndexes[(unsigned char) transition.input];
+            if (symbol == -1) {
+                throw invalid_argument("transition on a symbol outside the alphabet");
+            }
+            StaticDFA::transitions[indexOf(states, transition.from) * SymbolCount + symbol] =
+                    indexOf(states, transition.to);
+        }
+    }
+
+    constexpr bool accepts(string_view input) const {
+        uint32_t currentState = startState;
+        for (char c : input) {
+            if (currentState == deadState) {
+                return false;
+            }
+            currentState = getTransitionOn(currentState, c);
+        }
+        return isAccepting(currentState);
+    }
+
+    // Same language with the fewest states, like CompiledDFA::minimize(): unreachable and dead
+    // states are dropped, the rest is merged by Moore's partition refinement (quadratic, which is
+    // fine for the small automata this is meant for). Classes are numbered by their first state.
+    constexpr StaticDFA minimize() const {
+        StaticDFA minimal;
+        minimal.alfabet = alfabet;
+        minimal.symbolIndexes = symbolIndexes;
+
+        // 1. Bereikbaar vanaf de start
+        array<bool, StateCount> keep{};
+        array<uint32_t, StateCount> stateQueue{};
+        size_t queued = 0;
+        if (startState != deadState) {
+            keep[startState] = true;
+            stateQueue[queued++] = startState;
+        }
+        for (size_t head = 0; head < queued; ++head) {
+            for (size_t symbol = 0; symbol < SymbolCount; ++symbol) {
+                uint32_t to = transitions[stateQueue[head] * SymbolCount + symbol];
+                if (to != deadState && !keep[to]) {
+                    keep[to] = true;
+                    stateQueue[queued++] = to;
+                }
+            }
+        }
+
+        // 2. Levend: kan een accepterende staat bereiken (herhaal tot er niets meer verandert)
+        array<bool, StateCount> live{};
+        for (uint32_t state = 0; state < stateCount; ++state) {
+            live[state] = accepting[state];
+        }
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (uint32_t state = 0; state < stateCount; ++state) {
+                for (size_t symbol = 0; symbol < SymbolCount && !live[state]; ++symbol) {
+                    uint32_t to = transitions[state * SymbolCount + symbol];
+                    if (to != deadState && live[to]) {
+                        live[state] = changed = true;
+                    }
+                }
+            }
+        }
+        for (uint32_t state = 0; state < stateCount; ++state) {
+            keep[state] = keep[state] && live[state];
+        }
+        if (startState == deadState || !keep[startState]) {
+            return minimal;
+        }
+
+        // 3. Moore: klasse = (klasse, klassen van de opvolgers), de put heeft klasse deadState
+        array<uint32_t, StateCount> classOf{};
+        for (uint32_t state = 0; state < stateCount; ++state) {
+            classOf[state] = accepting[state] ? 1 : 0;
+        }
+        auto successorClass = [&](const array<uint32_t, StateCount> &classes, uint32_t state, size_t symbol) {
+            uint32_t to = transitions[state * SymbolCount + symbol];
+            return to == deadState || !keep[to] ? deadState : classes[to];
+        };
+        for (bool changed = true; changed;) {
+            array<uint32_t, StateCount> refined{};
+            array<uint32_t, StateCount> firstOfClass{};
+            uint32_t classCount = 0;
+            for (uint32_t state = 0; state < stateCount; ++state) {
+                if (!keep[state]) {
+                    continue;
+                }
+                uint32_t found = deadState;
+                for (uint32_t c = 0; c < classCount && found == deadState; ++c) {
+                    uint32_t other = firstOfClass[c];
+                    bool same = classOf[other] == classOf[state];
+                    for (size_t symbol = 0; symbol < SymbolCount && same; ++symbol) {
+                        same = successorClass(classOf, other, symbol) == successorClass(classOf, state, symbol);
+                    }
+                    if (same) {
+                        found = c;
+                    }
+                }
+                if (found == deadState) {
+                    found = classCount;
+                    firstOfClass[classCount++] = state;
+                }
+                refined[state] = found;
+            }
+            // Een verfijning splitst enkel, dus hetzelfde aantal klassen betekent een vast punt
+            changed = classCount != minimal.stateCount;
+            minimal.stateCount = classCount;
+            classOf = refined;
+        }
+
+        // 4. Quotiënt, elke klasse neemt de transities van haar eerste staat over
+        array<bool, StateCount> done{};
+        for (uint32_t state = 0; state < stateCount; ++state) {
+            if (!keep[state] || done[classOf[state]]) {
+                continue;
+            }
+            uint32_t c = classOf[state];
+            done[c] = true;
+            minimal.accepting[c] = accepting[state];
+            for (size_t symbol = 0; symbol < SymbolCount; ++symbol) {
+                minimal.transitions[c * SymbolCount + symbol] = successorClass(classOf, state, symbol);
+            }
+        }
+        minimal.startState = classOf[startState];
+        return minimal;
+    }
+
+    // Getters
+    constexpr uint32_t getStateCount() const {
+        return stateCount;
+    }
+
+    constexpr uint32_t getStartState() const {
+        return startState;
+    }
+
+    constexpr const array<char, SymbolCount> &getAlfabet() const {
+        return alfabet;
+    }
+
+    constexpr int getSymbolIndex(char c) const {
+        return symbolIndexes[(unsigned char) c];
+    }
+
+    constexpr uint32_t getTransition(uint32_t state, int symbolIndex) const {
+        if (state == deadState) {
+            return deadState;
+        }
+        return transitions[state * SymbolCount + symbolIndex];
+    }
+
+    constexpr uint32_t getTransitionOn(uint32_t state, char c) const {
+        int symbol = getSymbolIndex(c);
+        if (symbol == -1) {
+            return deadState;
+        }
+        return getTransition(state, symbol);
+    }
+
+    constexpr bool isAccepting(uint32_t state) const {
+        return state != deadState && accepting[state];
+    }
+};
+
+// StaticDFA(states, "ab", transitions) leidt StateCount en SymbolCount af uit de lengtes
+template <size_t StateCount, size_t AlfabetLength, size_t TransitionCount>
+StaticDFA(const StaticState (&)[StateCount], const char (&)[AlfabetLength], const StaticTransition (&)[TransitionCount])
+        -> StaticDFA<StateCount, AlfabetLength - 1>;
+
+
+#endif //TABLEFILLINGALGORITHM_STATICDFA_H
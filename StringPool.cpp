@@ -0,0 +1,115 @@
+//
+// Arena-backed pool of interned strings with stable 32-bit ids.
+//
+
+#include "StringPool.h"
+#include <cstring>
+#include <stdexcept>
+using namespace std;
+
+StringPool::StringPool() : blockUsed(blockSize), blockBytes(0), count(0) {
+    for (auto &segment : segments) {
+        segment.store(nullptr, memory_order_relaxed);
+    }
+}
+
+StringPool::~StringPool() {
+    for (auto &segment : segments) {
+        delete[] segment.load(memory_order_relaxed);
+    }
+}
+
+void StringPool::locate(uint32_t id, int &segment, size_t &offset) {
+    // id + 64 ligt in [64 << k, 128 << k) voor segment k
+    uint64_t shifted = uint64_t(id) + 64;
+    int highestBit = 63 - __builtin_clzll(shifted);
+    segment = highestBit - 6;
+    offset = shifted - (uint64_t(1) << highestBit);
+}
+
+uint32_t StringPool::intern(string_view value) {
+    lock_guard<mutex> lock(poolMutex);
+    auto it = ids.find(value);
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    uint32_t id = count.load(memory_order_relaxed);
+    if (id == UINT32_MAX) {
+        throw length_error("StringPool is full");
+    }
+
+    // Kopieer de tekens naar de arena; lange strings krijgen een eigen blok, de lege string geen
+    static char empty[1] = {};
+    char *characters;
+    if (value.empty()) {
+        characters = empty;
+    } else if (value.size() > blockSize / 4) {
+        blocks.emplace_back(new char[value.size()]);
+        blockBytes += value.size();
+        characters = blocks.back().get();
+        // Het huidige blok blijft bruikbaar: zet het nieuwe grote blok ervoor
+        if (blocks.size() > 1) {
+            swap(blocks[blocks.size() - 1], blocks[blocks.size() - 2]);
+        }
+    } else {
+        if (blockSize - blockUsed < value.size()) {
+            blocks.emplace_back(new char[blockSize]);
+            blockBytes += blockSize;
+            blockUsed = 0;
+        }
+        characters = blocks.back().get() + blockUsed;
+        blockUsed += value.size();
+    }
+    if (!value.empty()) {
+        memcpy(characters, value.data(), value.size());
+    }
+    string_view stored(characters, value.size());
+
+    int segment;
+    size_t offset;
+    locate(id, segment, offset);
+    string_view *entries = segments[segment].load(memory_order_relaxed);
+    if (entries == nullptr) {
+        entries = new string_view[size_t(64) << segment];
+        segments[segment].store(entries, memory_order_release);
+    }
+    entries[offset] = stored;
+    ids.emplace(stored, id);
+    count.store(id + 1, memory_order_release);
+    return id;
+}
+
+bool StringPool::find(string_view value, uint32_t &id) const {
+    lock_guard<mutex> lock(poolMutex);
+    auto it = ids.find(value);
+    if (it == ids.end()) {
+        return false;
+    }
+    id = it->second;
+    return true;
+}
+
+string_view StringPool::get(uint32_t id) const {
+    int segment;
+    size_t offset;
+    locate(id, segment, offset);
+    return segments[segment].load(memory_order_acquire)[offset];
+}
+
+uint32_t StringPool::size() const {
+    return count.load(memory_order_acquire);
+}
+
+size_t StringPool::memoryUsage() const {
+    lock_guard<mutex> lock(poolMutex);
+    size_t bytes = blockBytes + blocks.capacity() * sizeof(unique_ptr<char[]>);
+    for (int segment = 0; segment < segmentCount; ++segment) {
+        if (segments[segment].load(memory_order_relaxed)) {
+            bytes += (size_t(64) << segment) * sizeof(string_view);
+        }
+    }
+    // Knoop met de waarde, de volgende knoop en de bewaarde hash, plus de emmers
+    bytes += ids.size() * (sizeof(*ids.begin()) + 2 * sizeof(void *)) + ids.bucket_count() * sizeof(void *);
+    return bytes;
+}
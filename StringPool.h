@@ -0,0 +1,60 @@
+//
+// Arena-backed pool of interned strings with stable 32-bit ids.
+//
+
+#ifndef TABLEFILLINGALGORITHM_STRINGPOOL_H
+#define TABLEFILLINGALGORITHM_STRINGPOOL_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+
+// Every distinct string is stored once, in large arena blocks that never move, so the
+// string_views handed out stay valid for the lifetime of the pool. Ids are dense and assigned
+// in order of first interning. intern() and find() take a lock; get() does not, so the pool
+// can be shared by automata that are used on different threads.
+class StringPool {
+public:
+    // Size of an arena block; strings longer than a quarter block get a block of their own
+    static const size_t blockSize = 1 << 16;
+
+private:
+    // Segment k heeft 64 << k plaatsen, 27 segmenten zijn genoeg voor alle 32-bit ids
+    static const int segmentCount = 27;
+
+    vector<unique_ptr<char[]>> blocks;
+    size_t blockUsed;
+    size_t blockBytes;
+    array<atomic<string_view *>, segmentCount> segments;
+    atomic<uint32_t> count;
+    unordered_map<string_view, uint32_t> ids;
+    mutable mutex poolMutex;
+
+    static void locate(uint32_t id, int &segment, size_t &offset);
+
+public:
+    StringPool();
+    ~StringPool();
+
+    StringPool(const StringPool &) = delete;
+    StringPool &operator=(const StringPool &) = delete;
+
+    uint32_t intern(string_view value);
+    // false if value was never interned
+    bool find(string_view value, uint32_t &id) const;
+    string_view get(uint32_t id) const;
+    uint32_t size() const;
+    // Heap bytes of the arena, the id segments and the lookup table
+    size_t memoryUsage() const;
+};
+
+
+#endif //TABLEFILLINGALGORITHM_STRINGPOOL_H
@@ -0,0 +1,37 @@
+# tfa_generate_matcher(<target> INPUT <dfa file> FUNCTION <name> [STYLE switch|table] [NO_MINIMIZE])
+#
+# Generates <name>.h from a DFA file (JSON or the binary format) with TableFillingCodegen at build
+# time and makes it includable from <target>: #include "<name>.h" declares
+#     inline bool <name>(const char *input, std::size_t length);
+#     inline bool <name>(std::string_view input);
+# The header is regenerated when the DFA file or the generator changes. It only needs the
+# standard library, so <target> does not have to link TableFillingCore.
+function(tfa_generate_matcher target)
+    cmake_parse_arguments(MATCHER "NO_MINIMIZE" "INPUT;FUNCTION;STYLE" "" ${ARGN})
+    if (NOT MATCHER_INPUT OR NOT MATCHER_FUNCTION)
+        message(FATAL_ERROR "tfa_generate_matcher: INPUT and FUNCTION are required")
+    endif ()
+
+    set(options)
+    if (MATCHER_STYLE STREQUAL "table")
+        list(APPEND options --table)
+    elseif (MATCHER_STYLE AND NOT MATCHER_STYLE STREQUAL "switch")
+        message(FATAL_ERROR "tfa_generate_matcher: STYLE must be switch or table")
+    endif ()
+    if (MATCHER_NO_MINIMIZE)
+        list(APPEND options --no-minimize)
+    endif ()
+
+    get_filename_component(input ${MATCHER_INPUT} ABSOLUTE)
+    set(directory ${CMAKE_CURRENT_BINARY_DIR}/tfa_matchers)
+    set(output ${directory}/${MATCHER_FUNCTION}.h)
+    add_custom_command(
+            OUTPUT ${output}
+            COMMAND ${CMAKE_COMMAND} -E make_directory ${directory}
+            COMMAND TableFillingCodegen ${options} ${input} ${MATCHER_FUNCTION} ${output}
+            DEPENDS ${input} TableFillingCodegen
+            COMMENT "Generating matcher ${MATCHER_FUNCTION} from ${MATCHER_INPUT}"
+            VERBATIM)
+    target_sources(${target} PRIVATE ${output})
+    target_include_directories(${target} PRIVATE ${directory})
+endfunction()
@@ -0,0 +1,91 @@
+//
+// Fixed-size worker pool with an optionally bounded task queue.
+//
+
+#include "ThreadPool.h"
+#include "Trace.h"
+using namespace std;
+
+ThreadPool::ThreadPool(unsigned threadCount, size_t maxQueued)
+        : maxQueued(maxQueued), activeTasks(0), stopping(false) {
+    if (threadCount == 0) {
+        threadCount = defaultThreadCount();
+    }
+    for (unsigned i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::workerLoop(unsigned index) {
+    setTraceThreadName("worker " + to_string(index));
+    while (true) {
+        function<void()> task;
+        {
+            unique_lock<mutex> lock(queueMutex);
+            taskAvailable.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+            task = move(tasks.front());
+            tasks.pop();
+            ++activeTasks;
+        }
+        spaceAvailable.notify_one();
+
+        try {
+            task();
+        } catch (...) {
+            lock_guard<mutex> lock(queueMutex);
+            if (!firstError) {
+                firstError = current_exception();
+            }
+        }
+
+        {
+            lock_guard<mutex> lock(queueMutex);
+            --activeTasks;
+            if (activeTasks == 0 && tasks.empty()) {
+                allDone.notify_all();
+            }
+        }
+    }
+}
+
+void ThreadPool::submit(function<void()> task) {
+    {
+        unique_lock<mutex> lock(queueMutex);
+        spaceAvailable.wait(lock, [this] { return maxQueued == 0 || tasks.size() < maxQueued; });
+        tasks.push(move(task));
+    }
+    taskAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+    unique_lock<mutex> lock(queueMutex);
+    allDone.wait(lock, [this] { return activeTasks == 0 && tasks.empty(); });
+    if (firstError) {
+        exception_ptr error = firstError;
+        firstError = nullptr;
+        rethrow_exception(error);
+    }
+}
+
+unsigned ThreadPool::getThreadCount() const {
+    return workers.size();
+}
+
+unsigned ThreadPool::defaultThreadCount() {
+    unsigned count = thread::hardware_concurrency();
+    return count == 0 ? 1 : count;
+}
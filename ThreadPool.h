@@ -0,0 +1,55 @@
+//
+// Fixed-size worker pool with an optionally bounded task queue.
+//
+
+#ifndef TABLEFILLINGALGORITHM_THREADPOOL_H
+#define TABLEFILLINGALGORITHM_THREADPOOL_H
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+
+class ThreadPool {
+private:
+    vector<thread> workers;
+    queue<function<void()>> tasks;
+    size_t maxQueued;
+    size_t activeTasks;
+    bool stopping;
+    exception_ptr firstError;
+
+    mutex queueMutex;
+    condition_variable taskAvailable;
+    condition_variable spaceAvailable;
+    condition_variable allDone;
+
+    void workerLoop(unsigned index);
+
+public:
+    // threadCount 0 uses defaultThreadCount(), maxQueued 0 leaves the queue unbounded
+    explicit ThreadPool(unsigned threadCount = 0, size_t maxQueued = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Blocks while the queue is full, which throttles a producer that runs ahead of the workers
+    void submit(function<void()> task);
+
+    // Waits until every submitted task has finished, then rethrows the first exception a task threw
+    void wait();
+
+    unsigned getThreadCount() const;
+
+    static unsigned defaultThreadCount();
+};
+
+
+#endif //TABLEFILLINGALGORITHM_THREADPOOL_H
@@ -0,0 +1,202 @@
+//
+// Nested timed spans, exported in the Chrome trace_event format for Perfetto or chrome://tracing.
+//
+
+#include "Trace.h"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include <unistd.h>
+using namespace std;
+
+struct TraceEvent {
+    const char *name;
+    uint64_t start;
+    uint64_t duration;
+};
+
+// Eén schrijver (de eigen thread), lezers zien enkel events onder count. Volle blokken blijven
+// staan, een nieuw blok wordt achteraan gehangen.
+struct TraceChunk {
+    static const size_t capacity = 4096;
+    TraceEvent events[capacity];
+    atomic<size_t> count{0};
+    atomic<TraceChunk *> next{nullptr};
+};
+
+struct ThreadTrace {
+    uint32_t threadId;
+    string name;
+    TraceChunk first;
+    TraceChunk *last = &first;
+
+    ~ThreadTrace() {
+        TraceChunk *chunk = first.next.load();
+        while (chunk) {
+            TraceChunk *next = chunk->next.load();
+            delete chunk;
+            chunk = next;
+        }
+    }
+
+    void append(const TraceEvent &event) {
+        size_t count = last->count.load(memory_order_relaxed);
+        if (count == TraceChunk::capacity) {
+            TraceChunk *chunk = new TraceChunk;
+            last->next.store(chunk, memory_order_release);
+            last = chunk;
+            count = 0;
+        }
+        last->events[count] = event;
+        last->count.store(count + 1, memory_order_release);
+    }
+};
+
+struct TraceRegistry {
+    mutex lock;
+    vector<unique_ptr<ThreadTrace>> threads;
+};
+
+static atomic<bool> tracing{false};
+
+static TraceRegistry &registry() {
+    // Nooit vrijgegeven: threads kunnen nog spans afsluiten tijdens het afsluiten van het programma
+    static TraceRegistry *instance = new TraceRegistry;
+    return *instance;
+}
+
+static thread_local ThreadTrace *currentThread = nullptr;
+// Naam van setTraceThreadName() voor de thread een buffer heeft
+static thread_local string pendingName;
+
+static ThreadTrace &threadTrace() {
+    if (!currentThread) {
+        TraceRegistry &traces = registry();
+        lock_guard<mutex> guard(traces.lock);
+        traces.threads.push_back(make_unique<ThreadTrace>());
+        currentThread = traces.threads.back().get();
+        currentThread->threadId = traces.threads.size();
+        currentThread->name = pendingName.empty() ? "thread " + to_string(currentThread->threadId) : pendingName;
+    }
+    return *currentThread;
+}
+
+// Nanoseconden sinds de eerste oproep, nooit 0
+static uint64_t now() {
+    static const chrono::steady_clock::time_point epoch = chrono::steady_clock::now();
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - epoch).count() + 1;
+}
+
+static void writeJsonString(ostream &output, const string &value) {
+    output << '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            output << '\\' << c;
+        } else if ((unsigned char) c < 0x20) {
+            output << "\\u" << hex << setw(4) << setfill('0') << int(c) << dec << setfill(' ');
+        } else {
+            output << c;
+        }
+    }
+    output << '"';
+}
+
+void startTracing() {
+    now();
+    tracing.store(true, memory_order_relaxed);
+}
+
+void stopTracing() {
+    tracing.store(false, memory_order_relaxed);
+}
+
+bool isTracing() {
+    return tracing.load(memory_order_relaxed);
+}
+
+void clearTrace() {
+    TraceRegistry &traces = registry();
+    lock_guard<mutex> guard(traces.lock);
+    for (auto &thread : traces.threads) {
+        TraceChunk *chunk = thread->first.next.exchange(nullptr);
+        while (chunk) {
+            TraceChunk *next = chunk->next.load();
+            delete chunk;
+            chunk = next;
+        }
+        thread->first.count.store(0);
+        thread->last = &thread->first;
+    }
+}
+
+void writeChromeTrace(ostream &output) {
+    TraceRegistry &traces = registry();
+    lock_guard<mutex> guard(traces.lock);
+    int pid = getpid();
+    output << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    bool first = true;
+    auto separator = [&] {
+        output << (first ? "\n" : ",\n");
+        first = false;
+    };
+    ios::fmtflags flags = output.flags();
+    output << fixed << setprecision(3);
+    for (const auto &thread : traces.threads) {
+        separator();
+        output << "{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": " << pid << ", \"tid\": " << thread->threadId
+               << ", \"args\": {\"name\": ";
+        writeJsonString(output, thread->name);
+        output << "}}";
+        for (const TraceChunk *chunk = &thread->first; chunk; chunk = chunk->next.load(memory_order_acquire)) {
+            size_t count = chunk->count.load(memory_order_acquire);
+            for (size_t i = 0; i < count; ++i) {
+                const TraceEvent &event = chunk->events[i];
+                separator();
+                // Chrome verwacht microseconden
+                output << "{\"ph\": \"X\", \"name\": ";
+                writeJsonString(output, event.name);
+                output << ", \"pid\": " << pid << ", \"tid\": " << thread->threadId
+                       << ", \"ts\": " << event.start / 1000.0 << ", \"dur\": " << event.duration / 1000.0 << "}";
+            }
+        }
+    }
+    output.flags(flags);
+    output << "\n]}\n";
+}
+
+void writeChromeTrace(const string &outputFile) {
+    ofstream output(outputFile);
+    writeChromeTrace(output);
+    if (!output) {
+        throw runtime_error("cannot write " + outputFile);
+    }
+}
+
+void setTraceThreadName(const string &name) {
+    if (!currentThread) {
+        pendingName = name;
+        return;
+    }
+    lock_guard<mutex> guard(registry().lock);
+    currentThread->name = name;
+}
+
+TraceSpan::TraceSpan(const char *name) : name(name), start(isTracing() ? now() : 0) {}
+
+TraceSpan::~TraceSpan() {
+    end();
+}
+
+void TraceSpan::end() {
+    if (start == 0) {
+        return;
+    }
+    uint64_t finish = now();
+    threadTrace().append({name, start, finish - start});
+    start = 0;
+}
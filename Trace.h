@@ -0,0 +1,53 @@
+//
+// Nested timed spans, exported in the Chrome trace_event format for Perfetto or chrome://tracing.
+//
+
+#ifndef TABLEFILLINGALGORITHM_TRACE_H
+#define TABLEFILLINGALGORITHM_TRACE_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+using namespace std;
+
+
+// Nothing is recorded until startTracing(); a span then costs two clock reads and an append to a
+// buffer owned by its thread, without locks (only the first span of a thread registers its
+// buffer). Buffers outlive their threads, so the spans of finished pool workers are exported too.
+void startTracing();
+void stopTracing();
+bool isTracing();
+
+// Forgets every recorded span. Only while no other thread is recording.
+void clearTrace();
+
+// {"traceEvents": [...]}: a complete ("X") event per span and the name of every thread that
+// recorded one. Safe while other threads keep recording; their newest spans may be missing.
+void writeChromeTrace(ostream &output);
+void writeChromeTrace(const string &outputFile);
+
+// Name of the calling thread in the trace, e.g. "worker 2"; "thread <n>" by default
+void setTraceThreadName(const string &name);
+
+// Records the time from construction to end() or destruction. The name must outlive the
+// trace (a string literal): only the pointer is stored.
+class TraceSpan {
+private:
+    const char *name;
+    // 0 als er niet opgenomen wordt of de span al beëindigd is
+    uint64_t start;
+
+public:
+    explicit TraceSpan(const char *name);
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+    // Ends the span before the end of its scope
+    void end();
+};
+
+
+#endif //TABLEFILLINGALGORITHM_TRACE_H
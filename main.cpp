@@ -0,0 +1,165 @@
+//
+// Batch front end: reads jobs as JSON lines (see JobRunner.h) and writes one result line per job.
+// With --serve it runs a DFAServer on a UNIX socket instead.
+//
+
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include "BinaryDFA.h"
+#include "DFAServer.h"
+#include "JobRunner.h"
+#include "MinimizationCache.h"
+#include "MinimizationStats.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+using namespace std;
+
+struct Options {
+    unsigned threads = 0;
+    size_t queue = 0;
+    bool stats = false;
+    string traceFile;
+    string jobsFile = "-";
+    // Server
+    string socketPath;
+    size_t maxBatch = 64;
+    // name=path, bij het starten van de server geladen
+    vector<string> preload;
+};
+
+static int usage() {
+    cerr << "usage: TableFillingAlgorithm [--threads n] [--queue n] [--cache-dir directory] [--stats]\n"
+            "                             [--trace file] [jobs.jsonl | -]\n"
+            "       TableFillingAlgorithm --serve socket [--load name=path]... [--max-batch n] [--threads n]\n"
+            "                             [--queue n] [--cache-dir directory] [--stats] [--trace file]\n"
+            "Reads one job per line from the file or standard input and writes one result per line to\n"
+            "standard output, in the order the jobs finish; \"id\" links a result to its job. Ops:\n"
+            "  minimize     dfa [algorithm hopcroft|table] [output path] [binary bool]\n"
+            "  equivalence  dfa other\n"
+            "  accepts      dfa inputs [engine table|jit]\n"
+            "  fingerprint  dfa\n"
+            "An automaton is a file path (JSON or binary) or an inline DFA object.\n"
+            "--serve keeps automata resident and answers the binary protocol of ServerProtocol.h until\n"
+            "SIGINT or SIGTERM." << endl;
+    return 2;
+}
+
+static int runJobs(const Options &options) {
+    ifstream file;
+    if (options.jobsFile != "-") {
+        file.open(options.jobsFile);
+        if (!file) {
+            cerr << "cannot open " << options.jobsFile << endl;
+            return 1;
+        }
+    }
+    istream &input = options.jobsFile == "-" ? cin : file;
+    ios::sync_with_stdio(false);
+
+    JobRunner runner;
+    mutex outputMutex;
+    // Standaard twee jobs per worker in de wachtrij: genoeg om ze bezig te houden, en een grote
+    // invoer wordt niet helemaal ingelezen voor de eerste resultaten er zijn
+    unsigned threads = options.threads == 0 ? ThreadPool::defaultThreadCount() : options.threads;
+    ThreadPool pool(threads, options.queue == 0 ? 2 * size_t(threads) : options.queue);
+    string line;
+    while (getline(input, line)) {
+        if (line.find_first_not_of(" \t\r") == string::npos) {
+            continue;
+        }
+        pool.submit([&runner, &outputMutex, line = move(line)]() {
+            string result = runner.run(line);
+            lock_guard<mutex> lock(outputMutex);
+            cout << result << '\n';
+            // Per regel doorspoelen, zodat een aanroeper de resultaten kan verwerken terwijl ze binnenkomen
+            cout.flush();
+        });
+    }
+    pool.wait();
+    return 0;
+}
+
+static DFAServer *runningServer = nullptr;
+
+static void stopServer(int) {
+    if (runningServer != nullptr) {
+        runningServer->stop();
+    }
+}
+
+static int serve(const Options &options) {
+    try {
+        DFAServer server(options.socketPath, options.threads, options.queue, options.maxBatch);
+        for (const auto &entry : options.preload) {
+            size_t equals = entry.find('=');
+            string name = entry.substr(0, equals);
+            auto loaded = server.load(name, readDFAFile(entry.substr(equals + 1)));
+            cerr << name << ": " << loaded->getDFA().getStateCount() << " states, "
+                 << loaded->getMinimal().getStateCount() << " minimal" << endl;
+        }
+        runningServer = &server;
+        signal(SIGINT, stopServer);
+        signal(SIGTERM, stopServer);
+        cerr << "listening on " << options.socketPath << endl;
+        server.run();
+        runningServer = nullptr;
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    try {
+        bool hasJobsFile = false;
+        for (int i = 1; i < argc; ++i) {
+            bool hasValue = i + 1 < argc;
+            if (strcmp(argv[i], "--threads") == 0 && hasValue) {
+                options.threads = stoul(argv[++i]);
+            } else if (strcmp(argv[i], "--queue") == 0 && hasValue) {
+                options.queue = stoul(argv[++i]);
+            } else if (strcmp(argv[i], "--cache-dir") == 0 && hasValue) {
+                MinimizationCache::setDefaultDirectory(argv[++i]);
+            } else if (strcmp(argv[i], "--stats") == 0) {
+                options.stats = true;
+            } else if (strcmp(argv[i], "--trace") == 0 && hasValue) {
+                options.traceFile = argv[++i];
+            } else if (strcmp(argv[i], "--serve") == 0 && hasValue) {
+                options.socketPath = argv[++i];
+            } else if (strcmp(argv[i], "--max-batch") == 0 && hasValue) {
+                options.maxBatch = stoul(argv[++i]);
+            } else if (strcmp(argv[i], "--load") == 0 && hasValue && strchr(argv[i + 1], '=') != nullptr) {
+                options.preload.push_back(argv[++i]);
+            } else if (!hasJobsFile && (argv[i][0] != '-' || strcmp(argv[i], "-") == 0)) {
+                options.jobsFile = argv[i];
+                hasJobsFile = true;
+            } else {
+                return usage();
+            }
+        }
+        if (options.socketPath.empty() ? !options.preload.empty() : hasJobsFile) {
+            return usage();
+        }
+    } catch (const exception &) {
+        return usage();
+    }
+
+    if (!options.traceFile.empty()) {
+        startTracing();
+    }
+    int status = options.socketPath.empty() ? runJobs(options) : serve(options);
+    if (!options.traceFile.empty()) {
+        stopTracing();
+        writeChromeTrace(options.traceFile);
+    }
+    if (options.stats) {
+        writeMinimizationStatsJson(getMinimizationStats(), cerr);
+        cerr << endl;
+    }
+    return status;
+}